@@ -0,0 +1,51 @@
+/*
+ * Counts heap allocations by interposing the glibc allocator entry points.
+ * operator new/delete end up here too.
+ */
+#include <malloc.h>
+#include "alloc_count.h"
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void  __libc_free(void *ptr);
+}
+
+AllocStats allocStats = {};
+
+static inline void trackAlloc(void *p) {
+  allocStats.live += malloc_usable_size(p);
+  if (allocStats.live > allocStats.peak) allocStats.peak = allocStats.live;
+}
+
+extern "C" void *malloc(size_t size) {
+  void *p = __libc_malloc(size);
+  if (p) { allocStats.allocs++; trackAlloc(p); }
+  return p;
+}
+
+extern "C" void *calloc(size_t nmemb, size_t size) {
+  void *p = __libc_calloc(nmemb, size);
+  if (p) { allocStats.allocs++; trackAlloc(p); }
+  return p;
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+  if (ptr && !size) { free(ptr); return nullptr; }
+  size_t old = ptr ? malloc_usable_size(ptr) : 0;
+  void *p = __libc_realloc(ptr, size);
+  if (!p) return p;
+  if (ptr) allocStats.reallocs++;
+  else     allocStats.allocs++;
+  allocStats.live -= old;
+  trackAlloc(p);
+  return p;
+}
+
+extern "C" void free(void *ptr) {
+  if (!ptr) return;
+  allocStats.frees++;
+  allocStats.live -= malloc_usable_size(ptr);
+  __libc_free(ptr);
+}
@@ -0,0 +1,17 @@
+#pragma once
+/*
+ * Heap allocation counters (glibc only: malloc & co. are interposed in alloc_count.cpp).
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+struct AllocStats {
+  uint32_t allocs;    // successful malloc/calloc/realloc(nullptr) calls
+  uint32_t reallocs;  // realloc calls on existing blocks
+  uint32_t frees;     // free calls on non-null pointers
+  size_t   live;      // bytes currently allocated
+  size_t   peak;      // highest value of live since last reset
+};
+extern AllocStats allocStats;
+
+inline void resetAllocPeak() { allocStats.peak = allocStats.live; }
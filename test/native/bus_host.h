@@ -0,0 +1,15 @@
+#pragma once
+/*
+ * Force-included into bus_manager.cpp instead of wled_host.h: bus_manager.cpp does not include wled.h,
+ * it only needs the in-memory PolyBus in place of bus_wrapper.h.
+ */
+#define BusWrapper_h
+
+#ifdef __cplusplus
+#include <Arduino.h>
+#include <IPAddress.h>
+#include "const.h"
+#include "pin_manager.h"
+#include "bus_manager.h"
+#include "polybus_host.h"
+#endif
@@ -0,0 +1,232 @@
+/*
+ * Compares the packed two-channel (SWAR) color_blend(), color_add() and color_fade() and their span variants
+ * with the per-channel implementations they replaced, and benchmarks both.
+ *
+ * 8 bit blend, fade and saturating add are checked exhaustively per channel (every channel value pair and every
+ * blend/fade amount, with different values in the other channels); 16 bit blend, ratio preserving add and the
+ * span variants are checked with random colors.
+ *
+ * Usage: color_test [--random N] [--bench ITERATIONS]
+ * Exits with 1 on the first mismatch.
+ */
+#include <chrono>
+#include <vector>
+#include "wled_host.h"
+
+// per-channel reference implementations (colors.cpp before the SWAR rewrite)
+static uint32_t ref_color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16) {
+  if (blend == 0) return color1;
+  unsigned blendmax = b16 ? 0xFFFF : 0xFF;
+  if (blend == blendmax) return color2;
+  unsigned shift = b16 ? 16 : 8;
+
+  uint32_t w1 = W(color1);
+  uint32_t r1 = R(color1);
+  uint32_t g1 = G(color1);
+  uint32_t b1 = B(color1);
+
+  uint32_t w2 = W(color2);
+  uint32_t r2 = R(color2);
+  uint32_t g2 = G(color2);
+  uint32_t b2 = B(color2);
+
+  uint32_t w3 = ((w2 * blend) + (w1 * (blendmax - blend))) >> shift;
+  uint32_t r3 = ((r2 * blend) + (r1 * (blendmax - blend))) >> shift;
+  uint32_t g3 = ((g2 * blend) + (g1 * (blendmax - blend))) >> shift;
+  uint32_t b3 = ((b2 * blend) + (b1 * (blendmax - blend))) >> shift;
+
+  return RGBW32(r3, g3, b3, w3);
+}
+
+static uint32_t ref_color_add(uint32_t c1, uint32_t c2, bool fast) {
+  if (c1 == BLACK) return c2;
+  if (c2 == BLACK) return c1;
+  if (fast) {
+    uint8_t r = R(c1);
+    uint8_t g = G(c1);
+    uint8_t b = B(c1);
+    uint8_t w = W(c1);
+    r = qadd8(r, R(c2));
+    g = qadd8(g, G(c2));
+    b = qadd8(b, B(c2));
+    w = qadd8(w, W(c2));
+    return RGBW32(r,g,b,w);
+  } else {
+    uint32_t r = R(c1) + R(c2);
+    uint32_t g = G(c1) + G(c2);
+    uint32_t b = B(c1) + B(c2);
+    uint32_t w = W(c1) + W(c2);
+    unsigned max = r;
+    if (g > max) max = g;
+    if (b > max) max = b;
+    if (w > max) max = w;
+    if (max < 256) return RGBW32(r, g, b, w);
+    else           return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
+  }
+}
+
+static uint32_t ref_color_fade(uint32_t c1, uint8_t amount, bool video) {
+  if (c1 == BLACK || amount + video == 0) return BLACK;
+  uint32_t scaledcolor; // color order is: W R G B from MSB to LSB
+  uint32_t r = R(c1);
+  uint32_t g = G(c1);
+  uint32_t b = B(c1);
+  uint32_t w = W(c1);
+  uint32_t scale = amount; // 32bit for faster calculation
+  if (video) {
+    scaledcolor  = (((r * scale) >> 8) + ((r && scale) ? 1 : 0)) << 16;
+    scaledcolor |= (((g * scale) >> 8) + ((g && scale) ? 1 : 0)) << 8;
+    scaledcolor |=  ((b * scale) >> 8) + ((b && scale) ? 1 : 0);
+    scaledcolor |= (((w * scale) >> 8) + ((w && scale) ? 1 : 0)) << 24;
+  } else {
+    scaledcolor  = ((r * scale) >> 8) << 16;
+    scaledcolor |= ((g * scale) >> 8) << 8;
+    scaledcolor |=  (b * scale) >> 8;
+    scaledcolor |= ((w * scale) >> 8) << 24;
+  }
+  return scaledcolor;
+}
+
+static uint32_t rngState = 0x12345678;
+static uint32_t rnd32() { // xorshift32, deterministic across runs
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+// random color with a bias towards black, saturated and equal channels (edge cases of the lane math)
+static uint32_t rndColor() {
+  uint32_t c = rnd32();
+  switch (rnd32() & 7) {
+    case 0: return c & 0x00FFFFFF;
+    case 1: return c | 0x80808080;
+    case 2: return c & 0x0F0F0F0F;
+    case 3: return (c & 0xFF) * 0x01010101;
+    default: return c;
+  }
+}
+
+static unsigned long checks = 0;
+
+static bool check(const char *what, uint32_t got, uint32_t expected, uint32_t c1, uint32_t c2, unsigned arg, bool flag) {
+  checks++;
+  if (got == expected) return true;
+  fprintf(stderr, "%s(0x%08X, 0x%08X, %u, %d) = 0x%08X, expected 0x%08X\n", what, c1, c2, arg, flag, got, expected);
+  return false;
+}
+
+// puts v into channel ch (0-3), the other channels get values derived from other
+static uint32_t channelColor(unsigned ch, unsigned v, unsigned other) {
+  uint32_t c = (other * 0x01010101u) ^ 0x5A3C96E1u;
+  return (c & ~(0xFFu << (8 * ch))) | (v << (8 * ch));
+}
+
+static bool testExhaustive() {
+  for (unsigned ch = 0; ch < 4; ch++) {
+    for (unsigned a = 0; a < 256; a++) {
+      for (unsigned b = 0; b < 256; b++) {
+        uint32_t c1 = channelColor(ch, a, b);
+        uint32_t c2 = channelColor(ch, b, a ^ 0xFF);
+        for (unsigned amount = 0; amount < 256; amount++) {
+          if (!check("color_blend", color_blend(c1, c2, amount), ref_color_blend(c1, c2, amount, false), c1, c2, amount, false)) return false;
+        }
+        for (bool fast : {false, true}) {
+          if (!check("color_add", color_add(c1, c2, fast), ref_color_add(c1, c2, fast), c1, c2, 0, fast)) return false;
+        }
+      }
+      uint32_t c = channelColor(ch, a, a + 1);
+      for (unsigned amount = 0; amount < 256; amount++) {
+        for (bool video : {false, true}) {
+          if (!check("color_fade", color_fade(c, amount, video), ref_color_fade(c, amount, video), c, 0, amount, video)) return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool testRandom(unsigned long n) {
+  for (unsigned long i = 0; i < n; i++) {
+    uint32_t c1 = rndColor();
+    uint32_t c2 = rndColor();
+    uint16_t b16 = rnd32();
+    uint8_t  b8  = b16;
+    if (!check("color_blend", color_blend(c1, c2, b8), ref_color_blend(c1, c2, b8, false), c1, c2, b8, false)) return false;
+    if (!check("color_blend", color_blend(c1, c2, b16, true), ref_color_blend(c1, c2, b16, true), c1, c2, b16, true)) return false;
+    for (bool flag : {false, true}) {
+      if (!check("color_add", color_add(c1, c2, flag), ref_color_add(c1, c2, flag), c1, c2, 0, flag)) return false;
+      if (!check("color_fade", color_fade(c1, b8, flag), ref_color_fade(c1, b8, flag), c1, 0, b8, flag)) return false;
+    }
+  }
+  return true;
+}
+
+static bool testSpans() {
+  const size_t len = 257; // odd length
+  std::vector<uint32_t> src(len), dst(len), got(len);
+  for (unsigned run = 0; run < 2000; run++) {
+    for (size_t i = 0; i < len; i++) { src[i] = rndColor(); dst[i] = rndColor(); }
+    uint16_t blend = rnd32();
+    bool flag = run & 1;
+    if (run % 7 == 0) blend = 0;
+
+    got = dst;
+    fadeSpan(got.data(), len, blend, flag);
+    for (size_t i = 0; i < len; i++) {
+      if (!check("fadeSpan", got[i], ref_color_fade(dst[i], blend, flag), dst[i], 0, blend & 0xFF, flag)) return false;
+    }
+    got = dst;
+    blendSpan(got.data(), src.data(), len, flag ? blend : blend & 0xFF, flag);
+    for (size_t i = 0; i < len; i++) {
+      if (!check("blendSpan", got[i], ref_color_blend(dst[i], src[i], flag ? blend : blend & 0xFF, flag), dst[i], src[i], blend, flag)) return false;
+    }
+    got = dst;
+    addSpan(got.data(), src.data(), len, flag);
+    for (size_t i = 0; i < len; i++) {
+      if (!check("addSpan", got[i], ref_color_add(dst[i], src[i], flag), dst[i], src[i], 0, flag)) return false;
+    }
+  }
+  return true;
+}
+
+// fade, blend and add a 1024 pixel buffer, as a transition or an effect trail does every frame
+static void bench(unsigned iterations) {
+  const size_t len = 1024;
+  std::vector<uint32_t> a(len), b(len);
+  for (size_t i = 0; i < len; i++) { a[i] = rndColor(); b[i] = rndColor(); }
+  volatile uint32_t sink = 0;
+
+  auto run = [&](const char *name, auto fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned it = 0; it < iterations; it++) fn(it);
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)iterations * len);
+    printf("%-22s %6.2f ns/px\n", name, ns);
+    sink = sink + a[0];
+  };
+
+  run("ref color_fade",  [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] = ref_color_fade(a[i] | 0x80808080, 200 + (it & 31), it & 1); });
+  run("color_fade",      [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] = color_fade(a[i] | 0x80808080, 200 + (it & 31), it & 1); });
+  run("fadeSpan",        [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] |= 0x80808080; fadeSpan(a.data(), len, 200 + (it & 31), it & 1); });
+  run("ref color_blend", [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] = ref_color_blend(a[i], b[i], 1 + (it & 127), false); });
+  run("color_blend",     [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] = color_blend(a[i], b[i], 1 + (it & 127)); });
+  run("blendSpan",       [&](unsigned it) { blendSpan(a.data(), b.data(), len, 1 + (it & 127)); });
+  run("ref color_add",   [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] = ref_color_add(a[i] & 0x7F7F7F7F, b[i], it & 1); });
+  run("color_add",       [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] = color_add(a[i] & 0x7F7F7F7F, b[i], it & 1); });
+  run("addSpan",         [&](unsigned it) { for (size_t i = 0; i < len; i++) a[i] &= 0x7F7F7F7F; addSpan(a.data(), b.data(), len, it & 1); });
+}
+
+int main(int argc, char **argv) {
+  unsigned long randomChecks = 1000000;
+  unsigned benchIterations = 0;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if      (!strcmp(argv[i], "--random")) randomChecks = strtoul(argv[i+1], nullptr, 10);
+    else if (!strcmp(argv[i], "--bench"))  benchIterations = strtoul(argv[i+1], nullptr, 10);
+  }
+
+  if (!testExhaustive() || !testRandom(randomChecks) || !testSpans()) return 1;
+  printf("%lu checks passed\n", checks);
+  if (benchIterations) bench(benchIterations);
+  return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Per-effect render benchmark for the host build of the render core.
+ *
+ * Steps WS2812FX::service() with a simulated clock (one frame per call) for every registered effect
+ * on 1D strips and 2D matrices of configurable size and reports, per effect:
+ *   us     - average wall time of one service() call (render, compositing and bus output) in microseconds
+ *   pps    - pixels per second (strip length * frames / total time)
+ *   allocs - heap allocations while running (excluding effect start-up, see below)
+ *   frees  - heap frees while running
+ *   peak   - peak heap growth in bytes while running, relative to the start of the run
+ *   setup  - heap allocations made by the first frame (effect data, pixel buffers, mapping tables)
+ *   data   - effect data (SEGENV.data) size in bytes
+ *   crc    - CRC16 of the final frame, changes when an effect's output changes
+ *
+ * Usage: fx_bench [--frames N] [--1d LEN]... [--2d WxH]... [--fx ID]... [--out FILE]
+ * Defaults: 100 frames, --1d 300 --2d 32x16, all effects, JSON to stdout.
+ */
+#include <chrono>
+#include <string>
+#include <vector>
+#include "wled_host.h"
+#include "alloc_count.h"
+
+extern uint32_t hostMillis;
+extern uint32_t hostMicros;
+
+struct BenchSize {
+  unsigned w, h;
+};
+
+// advances the simulated clock by one frame time, or further if the effect asked for a longer delay,
+// so that every service() call renders a frame (service() renders when millis() > next_time)
+static void advanceClock() {
+  unsigned long due = strip.getMainSegment().next_time + 1;
+  unsigned ms = max((unsigned long)strip.getFrameTime(), due > hostMillis ? due - hostMillis : 0UL);
+  hostMillis += ms;
+  hostMicros += ms * 1000;
+}
+
+// recreates buses, matrix and segments for a w*h strip (h == 1 for 1D)
+static bool setupStrip(unsigned w, unsigned h) {
+  BusManager::removeAll();
+  strip.isMatrix = h > 1;
+  strip.panel.clear();
+  if (strip.isMatrix) {
+    WS2812FX::Panel p;
+    p.width  = w;
+    p.height = h;
+    strip.panels = 1;
+    strip.panel.push_back(p);
+  }
+  unsigned total = w * h;
+  uint8_t pins[5] = {2, 255, 255, 255, 255};
+  for (unsigned start = 0; start < total; ) {
+    unsigned len = min(total - start, (unsigned)MAX_LEDS_PER_BUS);
+    BusConfig bc(TYPE_WS2812_RGB, pins, start, len, COL_ORDER_GRB, false, 0, RGBW_MODE_MANUAL_ONLY, 0, useGlobalLedBuffer);
+    if (BusManager::add(bc) < 0) return false;
+    start += len;
+    pins[0]++;
+  }
+  strip.finalizeInit();
+  strip.makeAutoSegments(true);
+  strip.setBrightness(255, true);
+  strip.setTransition(0);
+  return strip.getLengthTotal() == total;
+}
+
+static std::string effectName(uint8_t fx) {
+  const char *data = strip.getModeData(fx);
+  std::string name;
+  for (; *data && *data != '@'; data++) name += *data == '"' ? '\'' : *data;
+  return name;
+}
+
+static uint16_t frameCrc() {
+  std::vector<unsigned char> px;
+  px.reserve(strip.getLengthTotal() * 4);
+  for (unsigned i = 0; i < strip.getLengthTotal(); i++) {
+    uint32_t c = strip.getPixelColor(i);
+    for (unsigned b = 0; b < 4; b++) px.push_back(c >> (8 * b));
+  }
+  return crc16(px.data(), px.size());
+}
+
+static void benchEffect(FILE *out, uint8_t fx, unsigned frames, bool first) {
+  Segment &seg = strip.getMainSegment();
+  seg.setMode(fx, true); // loads effect defaults
+  seg.fill(BLACK);
+  hostMillis = hostMicros = 0;
+  strip.resetTimebase();
+
+  // first frame allocates effect data, pixel buffers and mapping tables
+  AllocStats before = allocStats;
+  advanceClock();
+  strip.service();
+  unsigned setupAllocs = allocStats.allocs - before.allocs;
+
+  before = allocStats;
+  resetAllocPeak();
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned f = 0; f < frames; f++) {
+    advanceClock();
+    strip.service();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  AllocStats after = allocStats;
+  double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+  unsigned len = strip.getLengthTotal();
+  double pps = us > 0 ? (double)len * frames * 1e6 / us : 0;
+
+  fprintf(out, "%s\n    {\"id\":%u,\"name\":\"%s\",\"us\":%.2f,\"pps\":%.0f,\"allocs\":%u,\"frees\":%u,\"peak\":%zu,\"setup\":%u,\"data\":%u,\"crc\":%u}",
+          first ? "" : ",", fx, effectName(fx).c_str(), us / frames, pps,
+          after.allocs - before.allocs, after.frees - before.frees,
+          after.peak > before.live ? after.peak - before.live : 0, setupAllocs,
+          (unsigned)seg.dataSize(), frameCrc());
+}
+
+static void usage(const char *name) {
+  fprintf(stderr, "usage: %s [--frames N] [--1d LEN]... [--2d WxH]... [--fx ID]... [--out FILE]\n", name);
+}
+
+int main(int argc, char **argv) {
+  unsigned frames = 100;
+  std::vector<BenchSize> sizes;
+  std::vector<unsigned> effects;
+  const char *outName = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) { usage(argv[0]); return 2; }
+    const char *val = argv[++i];
+    if (arg == "--frames") frames = max(1, atoi(val));
+    else if (arg == "--1d") sizes.push_back({(unsigned)atoi(val), 1});
+    else if (arg == "--2d") {
+      unsigned w = 0, h = 0;
+      if (sscanf(val, "%ux%u", &w, &h) != 2 || w < 2 || h < 2 || w > 255 || h > 255) { usage(argv[0]); return 2; }
+      sizes.push_back({w, h});
+    }
+    else if (arg == "--fx") effects.push_back(atoi(val));
+    else if (arg == "--out") outName = val;
+    else { usage(argv[0]); return 2; }
+  }
+  if (sizes.empty()) sizes = {{300, 1}, {32, 16}};
+
+  FILE *out = outName ? fopen(outName, "w") : stdout;
+  if (!out) { perror(outName); return 1; }
+
+  int result = 0;
+  fprintf(out, "{\"frames\":%u,\"runs\":[", frames);
+  for (size_t s = 0; s < sizes.size(); s++) {
+    const BenchSize &size = sizes[s];
+    if (!size.w || size.w * size.h > MAX_LEDS || !setupStrip(size.w, size.h)) {
+      fprintf(stderr, "cannot set up %ux%u strip\n", size.w, size.h);
+      result = 1;
+      continue;
+    }
+    fprintf(out, "%s\n  {\"w\":%u,\"h\":%u,\"len\":%u,\"fx\":[", s ? "," : "", size.w, size.h, strip.getLengthTotal());
+    bool first = true;
+    for (unsigned fx = 0; fx < strip.getModeCount(); fx++) {
+      if (!effects.empty() && std::find(effects.begin(), effects.end(), fx) == effects.end()) continue;
+      if (strncmp_P("RSVD", strip.getModeData(fx), 4) == 0) continue;
+      benchEffect(out, fx, frames, first);
+      first = false;
+    }
+    fprintf(out, "\n  ]}");
+  }
+  fprintf(out, "\n]}\n");
+  if (out != stdout) fclose(out);
+  return result;
+}
@@ -0,0 +1,24 @@
+#pragma once
+/*
+ * Empty file system for host builds: ledmaps, custom palettes and presets are never found.
+ */
+#include "WString.h"
+
+class HostFile {
+  public:
+    operator bool() const { return false; }
+    size_t size() const { return 0; }
+    int read() { return -1; }
+    size_t readBytes(char *, size_t) { return 0; }
+    void close() {}
+};
+
+class HostFileSystem {
+  public:
+    bool exists(const char *) { return false; }
+    bool exists(const String &) { return false; }
+    HostFile open(const char *, const char * = "r") { return HostFile(); }
+    HostFile open(const String &, const char * = "r") { return HostFile(); }
+    bool remove(const char *) { return false; }
+};
+extern HostFileSystem HostFS;
@@ -0,0 +1,83 @@
+/*
+ * Definitions of the Arduino/ESP objects and WLED globals the render core links against.
+ * Defaults match wled.h.
+ */
+#include <chrono>
+#include "wled_host.h"
+#include "soc/ledc_struct.h"
+
+uint32_t hostMillis = 0;
+uint32_t hostMicros = 0;
+uint32_t hostFreeHeap = 160000; // reported by ESP.getFreeHeap(), lower it to exercise out of memory paths
+
+void delay(unsigned long ms) { hostMillis += ms; hostMicros += ms * 1000; }
+
+static uint32_t hostRandomState = 1;
+void randomSeed(unsigned long seed) { hostRandomState = seed ? seed : 1; }
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  hostRandomState ^= hostRandomState << 13; hostRandomState ^= hostRandomState >> 17; hostRandomState ^= hostRandomState << 5;
+  return hostRandomState % howbig;
+}
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+long map(long x, long in_min, long in_max, long out_min, long out_max) { return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min; }
+
+HardwareSerial Serial;
+EspClass ESP;
+uint32_t EspClass::getFreeHeap() { return hostFreeHeap; }
+// cycle counter of a 240MHz core, backed by the host clock (used by PerfCounters)
+uint32_t EspClass::getCycleCount() {
+  using namespace std::chrono;
+  return (uint32_t)(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() * 240 / 1000);
+}
+
+ledc_dev_t LEDC;
+HostFileSystem HostFS;
+
+// wled.h globals
+JsonDocument *pDoc = nullptr;
+volatile uint8_t jsonBufferLock = 0;
+SemaphoreHandle_t jsonBufferLockMutex = nullptr;
+byte briT = 0;
+bool useGlobalLedBuffer = true;
+uint8_t currentLedmap = 0;
+byte errorFlag = 0;
+byte lastRandomIndex = 0;
+bool fadeTransition = true;
+bool modeBlending = true;
+uint8_t blendingStyle = BLEND_STYLE_FADE;
+uint16_t transitionDelay = 750;
+uint8_t randomPaletteChangeTime = 5;
+bool useHarmonicRandomPalette = true;
+bool stateChanged = false;
+byte interfaceUpdateCallMode = CALL_MODE_INIT;
+String escapedMac;
+time_t localTime = 0;
+bool useAMPM = false;
+char *ledmapNames[WLED_MAX_LEDMAPS-1] = {nullptr};
+uint32_t ledMaps = 0;
+bool gammaCorrectCol = true;
+bool gammaCorrectBri = false;
+float gammaCorrectVal = 2.8f;
+bool cctICused = true;
+bool psramSafe = true;
+bool realtimeRespectLedMaps = true;
+byte realtimeMode = REALTIME_MODE_INACTIVE;
+byte realtimeOverride = REALTIME_OVERRIDE_NONE;
+bool correctPIN = true;
+char settingsPIN[5] = "";
+unsigned long lastEditTime = 0;
+char serverDescription[33] = "WLED";
+char cmDNS[33] = "wled";
+
+WS2812FX strip = WS2812FX();
+
+// FastLED beat functions use the effect clock (led.cpp)
+uint32_t get_millisecond_timer() { return strip.now; }
+
+// no usermods: audio reactive effects fall back to simulateSound()
+bool UsermodManager::getUMData(um_data_t **um_data, uint8_t mod_id) { return false; }
+
+// web server and network output are not part of the host build
+void createEditHandler(bool enable) {}
+uint8_t realtimeBroadcast(uint8_t type, const IPAddress *clients, NetBusStats **stats, uint8_t numClients, uint16_t length, const uint8_t *buffer, uint8_t bri, bool isRGBW) { return 0; }
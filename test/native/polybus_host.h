@@ -0,0 +1,49 @@
+#pragma once
+/*
+ * In-memory replacement for NeoPixelBus (bus_wrapper.h) used by host builds.
+ * Every digital bus stores its pixels in a plain array; show() only counts frames.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+
+#define I_NONE 0
+#define I_HOST 1
+
+struct HostPixelBus {
+  uint16_t len;
+  uint8_t  bri;
+  uint32_t shows;
+  uint32_t pixels[];
+};
+
+class PolyBus {
+  private:
+    static bool useParallelI2S;
+
+  public:
+    static inline void setParallelI2S1Output(bool b = true) { useParallelI2S = b; }
+    static inline bool isParallelI2S1Output(void) { return useParallelI2S; }
+
+    static uint8_t getI(uint8_t busType, uint8_t *pins, uint8_t num = 0) { return Bus::isDigital(busType) ? I_HOST : I_NONE; }
+    static void *create(uint8_t busType, uint8_t *pins, uint16_t len, uint8_t channel) {
+      HostPixelBus *bus = static_cast<HostPixelBus *>(calloc(1, sizeof(HostPixelBus) + len * sizeof(uint32_t)));
+      if (bus) { bus->len = len; bus->bri = 255; }
+      return bus;
+    }
+    static void begin(void *busPtr, uint8_t busType, uint8_t *pins, uint16_t clock_kHz) {}
+    static void cleanup(void *busPtr, uint8_t busType) { free(busPtr); }
+    static void show(void *busPtr, uint8_t busType, bool consistent = true) { if (busPtr) static_cast<HostPixelBus *>(busPtr)->shows++; }
+    static bool canShow(void *busPtr, uint8_t busType) { return true; }
+    static void setBrightness(void *busPtr, uint8_t busType, uint8_t b) { if (busPtr) static_cast<HostPixelBus *>(busPtr)->bri = b; }
+    // like NeoPixelBusLg, brightness is applied when the pixel is stored
+    static void setPixelColor(void *busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co, uint16_t wwcw = 0) {
+      HostPixelBus *bus = static_cast<HostPixelBus *>(busPtr);
+      if (!bus || pix >= bus->len) return;
+      unsigned scale = bus->bri + 1;
+      bus->pixels[pix] = ((((c & 0x00FF00FF) * scale) >> 8) & 0x00FF00FF) | ((((c >> 8) & 0x00FF00FF) * scale) & 0xFF00FF00);
+    }
+    static uint32_t getPixelColor(void *busPtr, uint8_t busType, uint16_t pix, uint8_t co) {
+      HostPixelBus *bus = static_cast<HostPixelBus *>(busPtr);
+      return bus && pix < bus->len ? bus->pixels[pix] : 0;
+    }
+};
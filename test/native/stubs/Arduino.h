@@ -0,0 +1,156 @@
+#pragma once
+/*
+ * Minimal Arduino core replacement for host builds of the WLED render core.
+ * Only what FX*.cpp, colors.cpp, wled_math.cpp and bus_manager.cpp use is provided.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <limits.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+using std::min;
+using std::max;
+
+#ifndef PI
+#define PI         3.1415926535897932384626433832795
+#endif
+#define HALF_PI    1.5707963267948966192313216916398
+#define TWO_PI     6.283185307179586476925286766559
+#ifndef M_TWOPI
+#define M_TWOPI    TWO_PI
+#endif
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define sq(x)        ((x)*(x))
+#define bitRead(value, bit)  (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit)   ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+#define lowByte(w)  ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+
+#define GPIO_PIN_COUNT 40
+
+#define HIGH 1
+#define LOW  0
+#define INPUT  0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define IRAM_ATTR
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define F(s) FPSTR(s)
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+// typed read so pointer tables (gGradientPalettes) survive 64 bit hosts
+template<typename T> inline T pgm_read_typed(const T *addr) { return *addr; }
+inline uint32_t pgm_read_typed(const void *addr) { return *(const uint32_t *)addr; }
+#define pgm_read_dword(addr) pgm_read_typed(addr)
+#define pgm_read_ptr(addr)   (*(void * const *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define memcpy_P   memcpy
+#define strlen_P   strlen
+#define strcpy_P   strcpy
+#define strcat_P   strcat
+#define strncpy_P  strncpy
+#define strcmp_P   strcmp
+#define strncmp_P  strncmp
+#define strcasecmp_P strcasecmp
+#define strstr_P   strstr
+#define strchr_P   strchr
+#define sprintf_P  sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+#define sscanf_P   sscanf
+
+class __FlashStringHelper;
+
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) { size_t n = len < size - 1 ? len : size - 1; memcpy(dst, src, n); dst[n] = 0; }
+  return len;
+}
+
+// FreeRTOS primitives used by the render core (the host build is single threaded)
+typedef void *SemaphoreHandle_t;
+typedef SemaphoreHandle_t xSemaphoreHandle;
+#define pdPASS  1
+#define pdTRUE  1
+#define pdFALSE 0
+#define portMAX_DELAY 0xFFFFFFFF
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return nullptr; }
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return nullptr; }
+inline int xSemaphoreTake(SemaphoreHandle_t, uint32_t) { return pdTRUE; }
+inline int xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+inline int xSemaphoreTakeRecursive(SemaphoreHandle_t, uint32_t) { return pdTRUE; }
+inline int xSemaphoreGiveRecursive(SemaphoreHandle_t) { return pdTRUE; }
+
+// simulated clock: host code advances it explicitly, so frame timing is deterministic
+extern uint32_t hostMillis;
+extern uint32_t hostMicros;
+inline unsigned long millis() { return hostMillis; }
+inline unsigned long micros() { return hostMicros; }
+void delay(unsigned long ms);
+inline void delayMicroseconds(unsigned us) { hostMicros += us; }
+inline void yield() {}
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int  digitalRead(uint8_t) { return LOW; }
+inline void analogWrite(uint8_t, int) {}
+inline int  analogRead(uint8_t) { return 0; }
+inline bool digitalPinIsValid(int pin) { return pin >= 0 && pin < GPIO_PIN_COUNT; }
+inline bool digitalPinCanOutput(int pin) { return pin >= 0 && pin < 34; }
+
+#include "WString.h"
+#include "Print.h"
+
+class HardwareSerial : public Print {
+  public:
+    size_t write(uint8_t c) override { return fputc(c, stderr) == EOF ? 0 : 1; }
+    int available() { return 0; }
+    int read() { return -1; }
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+  public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 240; }
+    const char *getChipModel() { return "ESP32-D0WD-V3"; }
+};
+extern EspClass ESP;
+
+inline bool psramFound() { return false; }
+#define ps_malloc  malloc
+#define ps_calloc  calloc
+#define ps_realloc realloc
+#define heap_caps_malloc_prefer(s, n, ...) malloc(s)
@@ -0,0 +1,2 @@
+#pragma once
+// the web server is not part of host builds; types are forward declared in wled_host.h
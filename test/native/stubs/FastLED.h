@@ -0,0 +1,285 @@
+#pragma once
+/*
+ * Host replacement for the parts of FastLED used by the WLED render core.
+ * Math follows FastLED 3.x (FASTLED_SCALE8_FIXED) closely enough for effects to look and behave the same;
+ * noise and hue conversion are reimplemented and are not bit exact.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t  fract8;
+typedef uint16_t fract16;
+typedef uint16_t accum88;
+typedef int16_t  saccum87;
+
+typedef const uint32_t TProgmemRGBPalette16[16];
+typedef const uint8_t *TProgmemRGBGradientPalette_bytes;
+typedef const uint8_t *TDynamicRGBGradientPalette_bytes;
+typedef const uint8_t TProgmemRGBGradientPalette_byte;
+
+typedef enum { NOBLEND = 0, LINEARBLEND = 1, LINEARBLEND_NOWRAP = 2 } TBlendType;
+typedef enum { FORWARD_HUES = 0, BACKWARD_HUES = 1, SHORTEST_HUES = 2, LONGEST_HUES = 3 } TGradientDirectionCode;
+
+// 8/16 bit math
+inline uint8_t  scale8(uint8_t i, fract8 scale)        { return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8; }
+inline uint8_t  scale8_video(uint8_t i, fract8 scale)  { return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0); }
+inline uint16_t scale16(uint16_t i, fract16 scale)     { return ((uint32_t)i * (1 + (uint32_t)scale)) >> 16; }
+inline uint16_t scale16by8(uint16_t i, fract8 scale)   { return (i * (1 + (uint32_t)scale)) >> 8; }
+inline uint8_t  qadd8(uint8_t i, uint8_t j)            { unsigned t = i + j; return t > 255 ? 255 : t; }
+inline int8_t   qadd7(int8_t i, int8_t j)              { int t = i + j; return t > 127 ? 127 : (t < -128 ? -128 : t); }
+inline uint8_t  qsub8(uint8_t i, uint8_t j)            { int t = i - j; return t < 0 ? 0 : t; }
+inline uint8_t  qmul8(uint8_t i, uint8_t j)            { unsigned p = (unsigned)i * j; return p > 255 ? 255 : p; }
+inline uint8_t  add8(uint8_t i, uint8_t j)             { return i + j; }
+inline uint8_t  sub8(uint8_t i, uint8_t j)             { return i - j; }
+inline uint8_t  mul8(uint8_t i, uint8_t j)             { return i * j; }
+inline uint8_t  avg8(uint8_t i, uint8_t j)             { return (i + j) >> 1; }
+inline uint16_t avg16(uint16_t i, uint16_t j)          { return (uint32_t)((uint32_t)i + (uint32_t)j) >> 1; }
+inline int8_t   avg7(int8_t i, int8_t j)               { return (i >> 1) + (j >> 1) + (i & 0x1); }
+inline int8_t   abs8(int8_t i)                         { return i < 0 ? -i : i; }
+inline uint8_t  map8(uint8_t in, uint8_t rangeStart, uint8_t rangeEnd) { return rangeStart + scale8(in, rangeEnd - rangeStart); }
+inline uint8_t  dim8_raw(uint8_t x)                    { return scale8(x, x); }
+inline uint8_t  dim8_video(uint8_t x)                  { return scale8_video(x, x); }
+inline uint8_t  brighten8_raw(uint8_t x)               { uint8_t ix = 255 - x; return 255 - scale8(ix, ix); }
+inline uint8_t  brighten8_video(uint8_t x)             { uint8_t ix = 255 - x; return 255 - scale8_video(ix, ix); }
+inline uint8_t  blend8(uint8_t a, uint8_t b, uint8_t amountOfB) { return ((uint16_t)a * (255 - amountOfB) + (uint16_t)b * amountOfB + 0x80) >> 8; }
+
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, fract8 frac) {
+  return b > a ? a + scale8(b - a, frac) : a - scale8(a - b, frac);
+}
+inline uint16_t lerp16by16(uint16_t a, uint16_t b, fract16 frac) {
+  return b > a ? a + scale16(b - a, frac) : a - scale16(a - b, frac);
+}
+inline uint16_t lerp16by8(uint16_t a, uint16_t b, fract8 frac) {
+  return b > a ? a + scale16by8(b - a, frac) : a - scale16by8(a - b, frac);
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i) {
+  uint8_t j = i;
+  if (j & 0x80) j = 255 - j;
+  uint8_t jj2 = scale8(j, j) << 1;
+  if (i & 0x80) jj2 = 255 - jj2;
+  return jj2;
+}
+inline uint8_t ease8InOutCubic(uint8_t i) {
+  uint8_t ii  = scale8(i, i);
+  uint8_t iii = scale8(ii, i);
+  uint16_t r1 = (3 * (uint16_t)ii) - (2 * (uint16_t)iii);
+  return (r1 & 0x100) ? 255 : r1;
+}
+inline uint8_t ease8InOutApprox(uint8_t i) {
+  if (i < 64) i /= 2;
+  else if (i > (255 - 64)) i = 255 - (255 - i) / 2;
+  else { i -= 64; i += i / 2; i += 32; }
+  return i;
+}
+inline uint16_t ease16InOutQuad(uint16_t i) {
+  uint16_t j = i;
+  if (j & 0x8000) j = 65535 - j;
+  uint16_t jj2 = scale16(j, j) << 1;
+  if (i & 0x8000) jj2 = 65535 - jj2;
+  return jj2;
+}
+inline uint8_t triwave8(uint8_t in)   { if (in & 0x80) in = 255 - in; return in << 1; }
+inline uint8_t quadwave8(uint8_t in)  { return ease8InOutQuad(triwave8(in)); }
+inline uint8_t cubicwave8(uint8_t in) { return ease8InOutCubic(triwave8(in)); }
+
+int16_t  sin16(uint16_t theta);
+inline int16_t cos16(uint16_t theta) { return sin16(theta + 16384); }
+uint8_t  sin8(uint8_t theta);
+inline uint8_t cos8(uint8_t theta)   { return sin8(theta + 64); }
+uint16_t sqrt16(uint16_t x);
+
+// random numbers (same generator as FastLED)
+extern uint16_t rand16seed;
+inline uint8_t  random8()                          { rand16seed = (rand16seed * 2053) + 13849; return (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8))); }
+inline uint8_t  random8(uint8_t lim)               { return (random8() * (unsigned)lim) >> 8; }
+inline uint8_t  random8(uint8_t min, uint8_t lim)  { return min + random8(lim - min); }
+inline uint16_t random16()                         { rand16seed = (rand16seed * 2053) + 13849; return rand16seed; }
+inline uint16_t random16(uint16_t lim)             { return ((uint32_t)random16() * lim) >> 16; }
+inline uint16_t random16(uint16_t min, uint16_t lim) { return min + random16(lim - min); }
+inline void     random16_set_seed(uint16_t seed)   { rand16seed = seed; }
+inline uint16_t random16_get_seed()                { return rand16seed; }
+inline void     random16_add_entropy(uint16_t entropy) { rand16seed += entropy; }
+
+// beat generators use the WLED effect clock
+uint32_t get_millisecond_timer();
+#define GET_MILLIS get_millisecond_timer
+inline uint16_t beat88(accum88 beats_per_minute_88, uint32_t timebase = 0) { return ((GET_MILLIS() - timebase) * beats_per_minute_88 * 280) >> 16; }
+inline uint16_t beat16(accum88 beats_per_minute, uint32_t timebase = 0)    { if (beats_per_minute < 256) beats_per_minute <<= 8; return beat88(beats_per_minute, timebase); }
+inline uint8_t  beat8(accum88 beats_per_minute, uint32_t timebase = 0)     { return beat16(beats_per_minute, timebase) >> 8; }
+inline uint8_t  beatsin8(accum88 beats_per_minute, uint8_t lowest = 0, uint8_t highest = 255, uint32_t timebase = 0, uint8_t phase_offset = 0) {
+  uint8_t beatsin = sin8(beat8(beats_per_minute, timebase) + phase_offset);
+  return lowest + scale8(beatsin, highest - lowest);
+}
+inline uint16_t beatsin16(accum88 beats_per_minute, uint16_t lowest = 0, uint16_t highest = 65535, uint32_t timebase = 0, uint16_t phase_offset = 0) {
+  uint16_t beatsin = sin16(beat16(beats_per_minute, timebase) + phase_offset) + 32768;
+  return lowest + scale16(beatsin, highest - lowest);
+}
+
+// noise
+uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z);
+uint16_t inoise16(uint32_t x, uint32_t y);
+uint16_t inoise16(uint32_t x);
+int16_t  inoise16_raw(uint32_t x, uint32_t y, uint32_t z);
+uint8_t  inoise8(uint16_t x, uint16_t y, uint16_t z);
+uint8_t  inoise8(uint16_t x, uint16_t y);
+uint8_t  inoise8(uint16_t x);
+int8_t   inoise8_raw(uint16_t x, uint16_t y, uint16_t z);
+int8_t   inoise8_raw(uint16_t x, uint16_t y);
+int8_t   inoise8_raw(uint16_t x);
+
+struct CRGB;
+
+struct CHSV {
+  union {
+    struct {
+      union { uint8_t hue; uint8_t h; };
+      union { uint8_t saturation; uint8_t sat; uint8_t s; };
+      union { uint8_t value; uint8_t val; uint8_t v; };
+    };
+    uint8_t raw[3];
+  };
+  CHSV() : hue(0), sat(0), val(0) {}
+  CHSV(uint8_t ih, uint8_t is, uint8_t iv) : hue(ih), sat(is), val(iv) {}
+  uint8_t &operator[](uint8_t x) { return raw[x]; }
+  const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+  CHSV &setHSV(uint8_t ih, uint8_t is, uint8_t iv) { h = ih; s = is; v = iv; return *this; }
+};
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+CHSV rgb2hsv_approximate(const CRGB &rgb);
+
+struct CRGB {
+  union {
+    struct {
+      union { uint8_t r; uint8_t red; };
+      union { uint8_t g; uint8_t green; };
+      union { uint8_t b; uint8_t blue; };
+    };
+    uint8_t raw[3];
+  };
+
+  typedef enum {
+    Aqua = 0x00FFFF, Black = 0x000000, Blue = 0x0000FF, Cyan = 0x00FFFF, DarkBlue = 0x00008B, DarkOrange = 0xFF8C00,
+    DarkRed = 0x8B0000, Gray = 0x808080, Green = 0x008000, Magenta = 0xFF00FF, Orange = 0xFFA500, Purple = 0x800080,
+    Red = 0xFF0000, White = 0xFFFFFF, Yellow = 0xFFFF00
+  } HTMLColorCode;
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+  CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+  CRGB(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+  CRGB &operator=(uint32_t colorcode) { r = (colorcode >> 16) & 0xFF; g = (colorcode >> 8) & 0xFF; b = colorcode & 0xFF; return *this; }
+  CRGB &operator=(const CHSV &rhs)    { hsv2rgb_rainbow(rhs, *this); return *this; }
+  uint8_t &operator[](uint8_t x) { return raw[x]; }
+  const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+  CRGB &setRGB(uint8_t nr, uint8_t ng, uint8_t nb) { r = nr; g = ng; b = nb; return *this; }
+  CRGB &setHSV(uint8_t hue, uint8_t sat, uint8_t val) { hsv2rgb_rainbow(CHSV(hue, sat, val), *this); return *this; }
+  CRGB &setHue(uint8_t hue) { hsv2rgb_rainbow(CHSV(hue, 255, 255), *this); return *this; }
+
+  CRGB &operator+=(const CRGB &rhs) { r = qadd8(r, rhs.r); g = qadd8(g, rhs.g); b = qadd8(b, rhs.b); return *this; }
+  CRGB &operator-=(const CRGB &rhs) { r = qsub8(r, rhs.r); g = qsub8(g, rhs.g); b = qsub8(b, rhs.b); return *this; }
+  CRGB &operator|=(const CRGB &rhs) { if (rhs.r > r) r = rhs.r; if (rhs.g > g) g = rhs.g; if (rhs.b > b) b = rhs.b; return *this; }
+  CRGB &operator&=(const CRGB &rhs) { if (rhs.r < r) r = rhs.r; if (rhs.g < g) g = rhs.g; if (rhs.b < b) b = rhs.b; return *this; }
+  CRGB &operator*=(uint8_t d)       { r = qmul8(r, d); g = qmul8(g, d); b = qmul8(b, d); return *this; }
+  CRGB &operator/=(uint8_t d)       { r /= d; g /= d; b /= d; return *this; }
+  CRGB &operator>>=(uint8_t d)      { r >>= d; g >>= d; b >>= d; return *this; }
+  CRGB &operator%=(uint8_t scale)   { return nscale8_video(scale); }
+  CRGB &operator++()                { return addToRGB(1); }
+  CRGB &operator--()                { return subtractFromRGB(1); }
+  CRGB &addToRGB(uint8_t d)         { r = qadd8(r, d); g = qadd8(g, d); b = qadd8(b, d); return *this; }
+  CRGB &subtractFromRGB(uint8_t d)  { r = qsub8(r, d); g = qsub8(g, d); b = qsub8(b, d); return *this; }
+
+  CRGB &nscale8(uint8_t scale)       { r = ::scale8(r, scale); g = ::scale8(g, scale); b = ::scale8(b, scale); return *this; }
+  CRGB &nscale8(const CRGB &scale)   { r = ::scale8(r, scale.r); g = ::scale8(g, scale.g); b = ::scale8(b, scale.b); return *this; }
+  CRGB &nscale8_video(uint8_t scale) { r = ::scale8_video(r, scale); g = ::scale8_video(g, scale); b = ::scale8_video(b, scale); return *this; }
+  CRGB &fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+  CRGB &fadeLightBy(uint8_t fadefactor)   { return nscale8_video(255 - fadefactor); }
+  CRGB  scale8(uint8_t scaledown) const   { CRGB out = *this; return out.nscale8(scaledown); }
+
+  uint8_t getAverageLight() const { return ::scale8(r, 85) + ::scale8(g, 85) + ::scale8(b, 85); }
+  uint8_t getLuma() const         { return ::scale8(r, 54) + ::scale8(g, 183) + ::scale8(b, 18); }
+  explicit operator bool() const  { return r || g || b; }
+  explicit operator uint32_t() const { return 0xFF000000 | (uint32_t(r) << 16) | (uint32_t(g) << 8) | uint32_t(b); }
+};
+
+inline bool operator==(const CRGB &lhs, const CRGB &rhs) { return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b; }
+inline bool operator!=(const CRGB &lhs, const CRGB &rhs) { return !(lhs == rhs); }
+inline CRGB operator+(const CRGB &p1, const CRGB &p2)    { return CRGB(qadd8(p1.r, p2.r), qadd8(p1.g, p2.g), qadd8(p1.b, p2.b)); }
+inline CRGB operator-(const CRGB &p1, const CRGB &p2)    { return CRGB(qsub8(p1.r, p2.r), qsub8(p1.g, p2.g), qsub8(p1.b, p2.b)); }
+inline CRGB operator*(const CRGB &p1, uint8_t d)         { return CRGB(qmul8(p1.r, d), qmul8(p1.g, d), qmul8(p1.b, d)); }
+inline CRGB operator/(const CRGB &p1, uint8_t d)         { return CRGB(p1.r / d, p1.g / d, p1.b / d); }
+inline CRGB operator%(const CRGB &p1, uint8_t d)         { CRGB r(p1); r.nscale8_video(d); return r; }
+inline CRGB operator|(const CRGB &p1, const CRGB &p2)    { CRGB r(p1); r |= p2; return r; }
+inline CRGB operator&(const CRGB &p1, const CRGB &p2)    { CRGB r(p1); r &= p2; return r; }
+
+CRGB  blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2);
+CRGB  HeatColor(uint8_t temperature);
+void  fill_solid(CRGB *targetArray, int numToFill, const CRGB &color);
+void  fill_gradient_RGB(CRGB *leds, uint16_t startpos, CRGB startcolor, uint16_t endpos, CRGB endcolor);
+void  fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2);
+void  fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3);
+void  fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4);
+void  fill_gradient(CRGB *leds, uint16_t startpos, CHSV startcolor, uint16_t endpos, CHSV endcolor, TGradientDirectionCode directionCode = SHORTEST_HUES);
+void  fill_gradient(CRGB *leds, uint16_t numLeds, const CHSV &c1, const CHSV &c2, TGradientDirectionCode directionCode = SHORTEST_HUES);
+void  fill_gradient(CRGB *leds, uint16_t numLeds, const CHSV &c1, const CHSV &c2, const CHSV &c3, TGradientDirectionCode directionCode = SHORTEST_HUES);
+void  fill_gradient(CRGB *leds, uint16_t numLeds, const CHSV &c1, const CHSV &c2, const CHSV &c3, const CHSV &c4, TGradientDirectionCode directionCode = SHORTEST_HUES);
+
+class CRGBPalette16 {
+  public:
+    CRGB entries[16];
+
+    CRGBPalette16() {}
+    CRGBPalette16(const CRGB &c00, const CRGB &c01, const CRGB &c02, const CRGB &c03,
+                  const CRGB &c04, const CRGB &c05, const CRGB &c06, const CRGB &c07,
+                  const CRGB &c08, const CRGB &c09, const CRGB &c10, const CRGB &c11,
+                  const CRGB &c12, const CRGB &c13, const CRGB &c14, const CRGB &c15) {
+      entries[0] = c00; entries[1] = c01; entries[2] = c02; entries[3] = c03;
+      entries[4] = c04; entries[5] = c05; entries[6] = c06; entries[7] = c07;
+      entries[8] = c08; entries[9] = c09; entries[10] = c10; entries[11] = c11;
+      entries[12] = c12; entries[13] = c13; entries[14] = c14; entries[15] = c15;
+    }
+    CRGBPalette16(const CHSV &c00, const CHSV &c01, const CHSV &c02, const CHSV &c03,
+                  const CHSV &c04, const CHSV &c05, const CHSV &c06, const CHSV &c07,
+                  const CHSV &c08, const CHSV &c09, const CHSV &c10, const CHSV &c11,
+                  const CHSV &c12, const CHSV &c13, const CHSV &c14, const CHSV &c15)
+    : CRGBPalette16(CRGB(c00), CRGB(c01), CRGB(c02), CRGB(c03), CRGB(c04), CRGB(c05), CRGB(c06), CRGB(c07),
+                    CRGB(c08), CRGB(c09), CRGB(c10), CRGB(c11), CRGB(c12), CRGB(c13), CRGB(c14), CRGB(c15)) {}
+    CRGBPalette16(const CRGB &c1)                                                 { fill_solid(entries, 16, c1); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2)                                 { fill_gradient_RGB(entries, 16, c1, c2); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3)                 { fill_gradient_RGB(entries, 16, c1, c2, c3); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4) { fill_gradient_RGB(entries, 16, c1, c2, c3, c4); }
+    CRGBPalette16(const CHSV &c1)                                                 { fill_solid(entries, 16, CRGB(c1)); }
+    CRGBPalette16(const CHSV &c1, const CHSV &c2)                                 { fill_gradient(entries, 16, c1, c2); }
+    CRGBPalette16(const CHSV &c1, const CHSV &c2, const CHSV &c3)                 { fill_gradient(entries, 16, c1, c2, c3); }
+    CRGBPalette16(const CHSV &c1, const CHSV &c2, const CHSV &c3, const CHSV &c4) { fill_gradient(entries, 16, c1, c2, c3, c4); }
+    CRGBPalette16(const TProgmemRGBPalette16 &rhs)                                { *this = rhs; }
+    CRGBPalette16(TProgmemRGBGradientPalette_bytes progpal)                       { *this = progpal; }
+
+    CRGBPalette16 &operator=(const TProgmemRGBPalette16 &rhs) { for (int i = 0; i < 16; i++) entries[i] = rhs[i]; return *this; }
+    CRGBPalette16 &operator=(TProgmemRGBGradientPalette_bytes progpal) { return loadDynamicGradientPalette(progpal); }
+    CRGBPalette16 &loadDynamicGradientPalette(TDynamicRGBGradientPalette_bytes gpal);
+
+    bool operator==(const CRGBPalette16 &rhs) const { return memcmp(entries, rhs.entries, sizeof(entries)) == 0; }
+    bool operator!=(const CRGBPalette16 &rhs) const { return !(*this == rhs); }
+    CRGB &operator[](uint8_t x) { return entries[x]; }
+    const CRGB &operator[](uint8_t x) const { return entries[x]; }
+    operator CRGB *() { return entries; }
+    operator const CRGB *() const { return entries; }
+};
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND);
+void nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges);
+
+extern const TProgmemRGBPalette16 CloudColors_p;
+extern const TProgmemRGBPalette16 LavaColors_p;
+extern const TProgmemRGBPalette16 OceanColors_p;
+extern const TProgmemRGBPalette16 ForestColors_p;
+extern const TProgmemRGBPalette16 RainbowColors_p;
+extern const TProgmemRGBPalette16 RainbowStripeColors_p;
+extern const TProgmemRGBPalette16 PartyColors_p;
+extern const TProgmemRGBPalette16 HeatColors_p;
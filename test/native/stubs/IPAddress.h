@@ -0,0 +1,18 @@
+#pragma once
+// IPv4 address holder
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress {
+  public:
+    IPAddress(uint32_t a = 0) { _a.dword = a; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { _a.bytes[0] = a; _a.bytes[1] = b; _a.bytes[2] = c; _a.bytes[3] = d; }
+    operator uint32_t() const { return _a.dword; }
+    uint8_t operator[](int i) const { return _a.bytes[i]; }
+    uint8_t &operator[](int i) { return _a.bytes[i]; }
+    bool operator==(const IPAddress &o) const { return _a.dword == o._a.dword; }
+    bool operator!=(const IPAddress &o) const { return _a.dword != o._a.dword; }
+    String toString() const { char b[16]; snprintf(b, sizeof(b), "%u.%u.%u.%u", _a.bytes[0], _a.bytes[1], _a.bytes[2], _a.bytes[3]); return String(b); }
+  private:
+    union { uint8_t bytes[4]; uint32_t dword; } _a;
+};
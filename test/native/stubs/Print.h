@@ -0,0 +1,56 @@
+#pragma once
+// Arduino Print base class
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "WString.h"
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t len) { size_t n = 0; while (len--) n += write(*buf++); return n; }
+    size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+
+    size_t print(const char *s)                 { return write(s); }
+    size_t print(const __FlashStringHelper *s)  { return write(reinterpret_cast<const char *>(s)); }
+    size_t print(const String &s)               { return write(s.c_str()); }
+    size_t print(char c)                        { return write((uint8_t)c); }
+    size_t print(int v, int base = 10)          { return printNumber(v, base); }
+    size_t print(unsigned v, int base = 10)     { return printNumber(v, base); }
+    size_t print(long v, int base = 10)         { return printNumber(v, base); }
+    size_t print(unsigned long v, int base = 10){ return printNumber(v, base); }
+    size_t print(double v, int digits = 2)      { return printf("%.*f", digits, v); }
+    template<typename T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+    template<typename T> size_t println(const T &v, int f) { size_t n = print(v, f); return n + println(); }
+    size_t println() { return write((uint8_t)'\n'); }
+
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+      char buf[256];
+      va_list args;
+      va_start(args, fmt);
+      int len = vsnprintf(buf, sizeof(buf), fmt, args);
+      va_end(args);
+      if (len < 0) return 0;
+      return write((const uint8_t *)buf, strnlen(buf, sizeof(buf)));
+    }
+    size_t printf_P(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+      char buf[256];
+      va_list args;
+      va_start(args, fmt);
+      int len = vsnprintf(buf, sizeof(buf), fmt, args);
+      va_end(args);
+      if (len < 0) return 0;
+      return write((const uint8_t *)buf, strnlen(buf, sizeof(buf)));
+    }
+
+  private:
+    size_t printNumber(long long v, int base) {
+      char buf[72];
+      if (base == 16) snprintf(buf, sizeof(buf), "%llx", v);
+      else snprintf(buf, sizeof(buf), "%lld", v);
+      return write(buf);
+    }
+};
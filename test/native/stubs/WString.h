@@ -0,0 +1,51 @@
+#pragma once
+// std::string backed replacement for the Arduino String class
+#include <string>
+#include <stdio.h>
+
+class __FlashStringHelper;
+
+class String {
+  public:
+    String(const char *s = "") : _s(s ? s : "") {}
+    String(const __FlashStringHelper *s) : _s(reinterpret_cast<const char *>(s)) {}
+    String(char c) : _s(1, c) {}
+    String(int v)           { _s = std::to_string(v); }
+    String(unsigned v)      { _s = std::to_string(v); }
+    String(long v)          { _s = std::to_string(v); }
+    String(unsigned long v) { _s = std::to_string(v); }
+    String(float v, unsigned d = 2)  { char b[32]; snprintf(b, sizeof(b), "%.*f", d, v); _s = b; }
+    String(double v, unsigned d = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", d, v); _s = b; }
+
+    const char *c_str() const { return _s.c_str(); }
+    unsigned length() const   { return _s.length(); }
+    bool isEmpty() const      { return _s.empty(); }
+    char operator[](unsigned i) const { return i < _s.length() ? _s[i] : 0; }
+    char charAt(unsigned i) const     { return (*this)[i]; }
+    void setCharAt(unsigned i, char c) { if (i < _s.length()) _s[i] = c; }
+    int indexOf(char c, unsigned from = 0) const { size_t p = _s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int indexOf(const char *s, unsigned from = 0) const { size_t p = _s.find(s, from); return p == std::string::npos ? -1 : (int)p; }
+    String substring(unsigned from) const { return from < _s.length() ? String(_s.substr(from).c_str()) : String(); }
+    String substring(unsigned from, unsigned to) const { return from < to && from < _s.length() ? String(_s.substr(from, to - from).c_str()) : String(); }
+    long toInt() const { return atol(_s.c_str()); }
+    bool reserve(unsigned n) { _s.reserve(n); return true; }
+    bool startsWith(const String &s) const { return _s.compare(0, s._s.length(), s._s) == 0; }
+    bool endsWith(const String &s) const { return _s.length() >= s._s.length() && _s.compare(_s.length() - s._s.length(), s._s.length(), s._s) == 0; }
+
+    String &operator+=(const String &s) { _s += s._s; return *this; }
+    String &operator+=(const char *s)   { _s += s; return *this; }
+    String &operator+=(char c)          { _s += c; return *this; }
+    String &operator+=(int v)           { _s += std::to_string(v); return *this; }
+    String &operator+=(unsigned v)      { _s += std::to_string(v); return *this; }
+    bool concat(const String &s) { _s += s._s; return true; }
+    bool operator==(const String &s) const { return _s == s._s; }
+    bool operator==(const char *s) const   { return _s == s; }
+    bool operator!=(const String &s) const { return _s != s._s; }
+
+    friend String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+    friend String operator+(const String &a, const char *b)   { String r(a); r += b; return r; }
+    friend String operator+(const char *a, const String &b)   { String r(a); r += b; return r; }
+
+  private:
+    std::string _s;
+};
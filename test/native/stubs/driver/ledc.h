@@ -0,0 +1,16 @@
+#pragma once
+// ESP-IDF LEDC driver replacement (PWM output is a no-op on the host)
+#include <stdint.h>
+
+typedef int ledc_mode_t;
+typedef int ledc_timer_t;
+typedef int ledc_channel_t;
+
+#define LEDC_CHANNEL_MAX    8
+#define LEDC_SPEED_MODE_MAX 2
+
+inline void ledcSetup(uint8_t, double, uint8_t) {}
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcDetachPin(uint8_t) {}
+inline int  ledc_timer_rst(ledc_mode_t, ledc_timer_t) { return 0; }
+inline int  ledc_update_duty(ledc_mode_t, ledc_channel_t) { return 0; }
@@ -0,0 +1,351 @@
+/*
+ * Host implementation of the FastLED functions declared in FastLED.h
+ */
+#include <math.h>
+#include "FastLED.h"
+
+uint16_t rand16seed = 1337;
+
+int16_t sin16(uint16_t theta) {
+  return (int16_t)lrintf(32767.0f * sinf(theta * (float)(2.0 * M_PI / 65536.0)));
+}
+
+uint8_t sin8(uint8_t theta) {
+  return (uint8_t)lrintf(127.5f + 127.5f * sinf(theta * (float)(2.0 * M_PI / 256.0)) - 0.5f);
+}
+
+uint16_t sqrt16(uint16_t x) {
+  if (x <= 1) return x;
+  uint16_t low = 1, hi, mid;
+  hi = x > 7904 ? 255 : (x >> 5) + 8;
+  do {
+    mid = (low + hi) >> 1;
+    if ((uint16_t)(mid * mid) > x) hi = mid - 1;
+    else {
+      if (mid == 255) return 255;
+      low = mid + 1;
+    }
+  } while (hi >= low);
+  return low - 1;
+}
+
+// improved Perlin noise with Ken Perlin's permutation table, scaled to FastLED's ranges
+static const uint8_t p[256] = {
+  151,160,137, 91, 90, 15,131, 13,201, 95, 96, 53,194,233,  7,225,140, 36,103, 30, 69,142,  8, 99, 37,240, 21, 10, 23,190,  6,148,
+  247,120,234, 75,  0, 26,197, 62, 94,252,219,203,117, 35, 11, 32, 57,177, 33, 88,237,149, 56, 87,174, 20,125,136,171,168, 68,175,
+   74,165, 71,134,139, 48, 27,166, 77,146,158,231, 83,111,229,122, 60,211,133,230,220,105, 92, 41, 55, 46,245, 40,244,102,143, 54,
+   65, 25, 63,161,  1,216, 80, 73,209, 76,132,187,208, 89, 18,169,200,196,135,130,116,188,159, 86,164,100,109,198,173,186,  3, 64,
+   52,217,226,250,124,123,  5,202, 38,147,118,126,255, 82, 85,212,207,206, 59,227, 47, 16, 58, 17,182,189, 28, 42,223,183,170,213,
+  119,248,152,  2, 44,154,163, 70,221,153,101,155,167, 43,172,  9,129, 22, 39,253, 19, 98,108,110, 79,113,224,232,178,185,112,104,
+  218,246, 97,228,251, 34,242,193,238,210,144, 12,191,179,162,241, 81, 51,145,235,249, 14,239,107, 49,192,214, 31,181,199,106,157,
+  184, 84,204,176,115,121, 50, 45,127,  4,150,254,138,236,205, 93,222,114, 67, 29, 24, 72,243,141,128,195, 78, 66,215, 61,156,180
+};
+#define P(x) p[(x) & 0xFF]
+
+static inline float fade(float t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+static inline float lerpf(float a, float b, float t) { return a + t * (b - a); }
+static inline float grad(int hash, float x, float y, float z) {
+  int h = hash & 15;
+  float u = h < 8 ? x : y;
+  float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+  return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+// x, y, z in units of 1/fracOne; returns -1..1
+static float perlin(uint32_t x, uint32_t y, uint32_t z, float fracOne, unsigned shift) {
+  int X = (x >> shift) & 0xFF, Y = (y >> shift) & 0xFF, Z = (z >> shift) & 0xFF;
+  uint32_t mask = (1UL << shift) - 1;
+  float fx = (x & mask) / fracOne, fy = (y & mask) / fracOne, fz = (z & mask) / fracOne;
+  float u = fade(fx), v = fade(fy), w = fade(fz);
+  int A = P(X) + Y, AA = P(A) + Z, AB = P(A + 1) + Z;
+  int B = P(X + 1) + Y, BA = P(B) + Z, BB = P(B + 1) + Z;
+  return lerpf(lerpf(lerpf(grad(P(AA),   fx,   fy,   fz  ), grad(P(BA),   fx-1, fy,   fz  ), u),
+                     lerpf(grad(P(AB),   fx,   fy-1, fz  ), grad(P(BB),   fx-1, fy-1, fz  ), u), v),
+               lerpf(lerpf(grad(P(AA+1), fx,   fy,   fz-1), grad(P(BA+1), fx-1, fy,   fz-1), u),
+                     lerpf(grad(P(AB+1), fx,   fy-1, fz-1), grad(P(BB+1), fx-1, fy-1, fz-1), u), v), w);
+}
+
+int16_t inoise16_raw(uint32_t x, uint32_t y, uint32_t z) {
+  return (int16_t)(perlin(x, y, z, 65536.0f, 16) * 18000.0f);
+}
+
+uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) {
+  int32_t ans = inoise16_raw(x, y, z) + 19052L;
+  uint32_t pan = (uint32_t)ans * 440L;
+  return pan >> 8;
+}
+uint16_t inoise16(uint32_t x, uint32_t y) { return inoise16(x, y, 0); }
+uint16_t inoise16(uint32_t x)             { return inoise16(x, 0, 0); }
+
+int8_t inoise8_raw(uint16_t x, uint16_t y, uint16_t z) {
+  return (int8_t)(perlin(x, y, z, 256.0f, 8) * 70.0f);
+}
+int8_t inoise8_raw(uint16_t x, uint16_t y) { return inoise8_raw(x, y, 0); }
+int8_t inoise8_raw(uint16_t x)             { return inoise8_raw(x, 0, 0); }
+
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z) {
+  int8_t n = inoise8_raw(x, y, z);
+  n = qadd7(n, 64);
+  return qadd8((uint8_t)n, (uint8_t)n);
+}
+uint8_t inoise8(uint16_t x, uint16_t y) { return inoise8(x, y, 0); }
+uint8_t inoise8(uint16_t x)             { return inoise8(x, 0, 0); }
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb) {
+  uint8_t hue = hsv.hue, sat = hsv.sat, val = hsv.val;
+  uint8_t offset8 = (hue & 0x1F) << 3;
+  uint8_t third = scale8(offset8, (256 / 3));
+  uint8_t r, g, b;
+  if (!(hue & 0x80)) {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { r = 255 - third; g = third; b = 0; }
+      else               { r = 171; g = 85 + third; b = 0; }
+    } else {
+      if (!(hue & 0x20)) { uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); r = 171 - twothirds; g = 170 + third; b = 0; }
+      else               { r = 0; g = 255 - third; b = third; }
+    }
+  } else {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); r = 0; g = 171 - twothirds; b = 85 + twothirds; }
+      else               { r = third; g = 0; b = 255 - third; }
+    } else {
+      if (!(hue & 0x20)) { r = 85 + third; g = 0; b = 171 - third; }
+      else               { r = 170 + third; g = 0; b = 85 - third; }
+    }
+  }
+  if (sat != 255) {
+    if (sat == 0) {
+      r = 255; b = 255; g = 255;
+    } else {
+      uint8_t desat = 255 - sat;
+      desat = scale8_video(desat, desat);
+      uint8_t satscale = 255 - desat;
+      if (r) r = scale8(r, satscale) + 1;
+      if (g) g = scale8(g, satscale) + 1;
+      if (b) b = scale8(b, satscale) + 1;
+      r += desat; g += desat; b += desat;
+    }
+  }
+  if (val != 255) {
+    val = scale8_video(val, val);
+    if (val == 0) {
+      r = 0; g = 0; b = 0;
+    } else {
+      if (r) r = scale8(r, val) + 1;
+      if (g) g = scale8(g, val) + 1;
+      if (b) b = scale8(b, val) + 1;
+    }
+  }
+  rgb.r = r; rgb.g = g; rgb.b = b;
+}
+
+CHSV rgb2hsv_approximate(const CRGB &rgb) {
+  uint8_t mx = rgb.r > rgb.g ? (rgb.r > rgb.b ? rgb.r : rgb.b) : (rgb.g > rgb.b ? rgb.g : rgb.b);
+  uint8_t mn = rgb.r < rgb.g ? (rgb.r < rgb.b ? rgb.r : rgb.b) : (rgb.g < rgb.b ? rgb.g : rgb.b);
+  uint8_t delta = mx - mn;
+  if (mx == 0) return CHSV(0, 0, 0);
+  uint8_t s = (255 * delta) / mx;
+  if (delta == 0) return CHSV(0, 0, mx);
+  int h;
+  if (mx == rgb.r)      h = 0   + 43 * (rgb.g - rgb.b) / delta;
+  else if (mx == rgb.g) h = 85  + 43 * (rgb.b - rgb.r) / delta;
+  else                  h = 171 + 43 * (rgb.r - rgb.g) / delta;
+  return CHSV((uint8_t)h, s, mx);
+}
+
+CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2) {
+  return CRGB(blend8(p1.r, p2.r, amountOfP2), blend8(p1.g, p2.g, amountOfP2), blend8(p1.b, p2.b, amountOfP2));
+}
+
+CRGB HeatColor(uint8_t temperature) {
+  uint8_t t192 = scale8_video(temperature, 191);
+  uint8_t heatramp = (t192 & 0x3F) << 2;
+  if (t192 & 0x80)      return CRGB(255, 255, heatramp);
+  else if (t192 & 0x40) return CRGB(255, heatramp, 0);
+  return CRGB(heatramp, 0, 0);
+}
+
+void fill_solid(CRGB *targetArray, int numToFill, const CRGB &color) {
+  for (int i = 0; i < numToFill; ++i) targetArray[i] = color;
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t startpos, CRGB startcolor, uint16_t endpos, CRGB endcolor) {
+  if (endpos < startpos) {
+    uint16_t t = endpos; endpos = startpos; startpos = t;
+    CRGB tc = endcolor; endcolor = startcolor; startcolor = tc;
+  }
+  saccum87 rdistance87 = (endcolor.r - startcolor.r) * 128;
+  saccum87 gdistance87 = (endcolor.g - startcolor.g) * 128;
+  saccum87 bdistance87 = (endcolor.b - startcolor.b) * 128;
+  uint16_t pixeldistance = endpos - startpos;
+  int16_t divisor = pixeldistance ? pixeldistance : 1;
+  saccum87 rdelta87 = (rdistance87 / divisor) * 2;
+  saccum87 gdelta87 = (gdistance87 / divisor) * 2;
+  saccum87 bdelta87 = (bdistance87 / divisor) * 2;
+  accum88 r88 = startcolor.r << 8;
+  accum88 g88 = startcolor.g << 8;
+  accum88 b88 = startcolor.b << 8;
+  for (uint16_t i = startpos; i <= endpos; ++i) {
+    leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+    r88 += rdelta87; g88 += gdelta87; b88 += bdelta87;
+  }
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2) {
+  fill_gradient_RGB(leds, 0, c1, numLeds - 1, c2);
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3) {
+  uint16_t half = numLeds / 2, last = numLeds - 1;
+  fill_gradient_RGB(leds, 0, c1, half, c2);
+  fill_gradient_RGB(leds, half, c2, last, c3);
+}
+
+void fill_gradient_RGB(CRGB *leds, uint16_t numLeds, const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4) {
+  uint16_t onethird = numLeds / 3, twothirds = (numLeds * 2) / 3, last = numLeds - 1;
+  fill_gradient_RGB(leds, 0, c1, onethird, c2);
+  fill_gradient_RGB(leds, onethird, c2, twothirds, c3);
+  fill_gradient_RGB(leds, twothirds, c3, last, c4);
+}
+
+void fill_gradient(CRGB *leds, uint16_t startpos, CHSV startcolor, uint16_t endpos, CHSV endcolor, TGradientDirectionCode directionCode) {
+  if (endpos < startpos) {
+    uint16_t t = endpos; endpos = startpos; startpos = t;
+    CHSV tc = endcolor; endcolor = startcolor; startcolor = tc;
+  }
+  if (endcolor.value == 0 || endcolor.saturation == 0) endcolor.hue = startcolor.hue;
+  if (startcolor.value == 0 || startcolor.saturation == 0) startcolor.hue = endcolor.hue;
+  saccum87 satdistance87 = (endcolor.sat - startcolor.sat) * 128;
+  saccum87 valdistance87 = (endcolor.val - startcolor.val) * 128;
+  uint8_t huedelta8 = endcolor.hue - startcolor.hue;
+  if (directionCode == SHORTEST_HUES) directionCode = huedelta8 > 127 ? BACKWARD_HUES : FORWARD_HUES;
+  if (directionCode == LONGEST_HUES)  directionCode = huedelta8 < 128 ? BACKWARD_HUES : FORWARD_HUES;
+  saccum87 huedistance87 = directionCode == FORWARD_HUES ? huedelta8 * 128 : -((uint8_t)(256 - huedelta8) * 128);
+  uint16_t pixeldistance = endpos - startpos;
+  int16_t divisor = pixeldistance ? pixeldistance : 1;
+  saccum87 huedelta87 = (huedistance87 / divisor) * 2;
+  saccum87 satdelta87 = (satdistance87 / divisor) * 2;
+  saccum87 valdelta87 = (valdistance87 / divisor) * 2;
+  accum88 hue88 = startcolor.hue << 8;
+  accum88 sat88 = startcolor.sat << 8;
+  accum88 val88 = startcolor.val << 8;
+  for (uint16_t i = startpos; i <= endpos; ++i) {
+    leds[i] = CHSV(hue88 >> 8, sat88 >> 8, val88 >> 8);
+    hue88 += huedelta87; sat88 += satdelta87; val88 += valdelta87;
+  }
+}
+
+void fill_gradient(CRGB *leds, uint16_t numLeds, const CHSV &c1, const CHSV &c2, TGradientDirectionCode directionCode) {
+  fill_gradient(leds, 0, c1, numLeds - 1, c2, directionCode);
+}
+
+void fill_gradient(CRGB *leds, uint16_t numLeds, const CHSV &c1, const CHSV &c2, const CHSV &c3, TGradientDirectionCode directionCode) {
+  uint16_t half = numLeds / 2, last = numLeds - 1;
+  fill_gradient(leds, 0, c1, half, c2, directionCode);
+  fill_gradient(leds, half, c2, last, c3, directionCode);
+}
+
+void fill_gradient(CRGB *leds, uint16_t numLeds, const CHSV &c1, const CHSV &c2, const CHSV &c3, const CHSV &c4, TGradientDirectionCode directionCode) {
+  uint16_t onethird = numLeds / 3, twothirds = (numLeds * 2) / 3, last = numLeds - 1;
+  fill_gradient(leds, 0, c1, onethird, c2, directionCode);
+  fill_gradient(leds, onethird, c2, twothirds, c3, directionCode);
+  fill_gradient(leds, twothirds, c3, last, c4, directionCode);
+}
+
+// gradient palette: 4 byte entries (index, r, g, b), last index is 255
+CRGBPalette16 &CRGBPalette16::loadDynamicGradientPalette(TDynamicRGBGradientPalette_bytes gpal) {
+  const uint8_t *ent = gpal;
+  unsigned count = 0;
+  do { count++; } while (ent[(count - 1) * 4] != 255);
+  int lastSlotUsed = -1;
+  CRGB rgbstart(ent[1], ent[2], ent[3]);
+  int indexstart = 0;
+  while (indexstart < 255) {
+    ent += 4;
+    int indexend = ent[0];
+    CRGB rgbend(ent[1], ent[2], ent[3]);
+    int istart8 = indexstart / 16;
+    int iend8   = indexend / 16;
+    if (count < 16) {
+      if (istart8 <= lastSlotUsed && lastSlotUsed < 15) {
+        istart8 = lastSlotUsed + 1;
+        if (iend8 < istart8) iend8 = istart8;
+      }
+      lastSlotUsed = iend8;
+    }
+    fill_gradient_RGB(entries, istart8, rgbstart, iend8, rgbend);
+    indexstart = indexend;
+    rgbstart = rgbend;
+  }
+  return *this;
+}
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness, TBlendType blendType) {
+  uint8_t hi4 = index >> 4;
+  uint8_t lo4 = index & 0x0F;
+  const CRGB *entry = &pal.entries[hi4];
+  uint8_t red1 = entry->r, green1 = entry->g, blue1 = entry->b;
+  if (lo4 && blendType != NOBLEND) {
+    if (hi4 == 15) entry = blendType == LINEARBLEND_NOWRAP ? entry : &pal.entries[0];
+    else entry++;
+    uint8_t f2 = lo4 << 4;
+    uint8_t f1 = 255 - f2;
+    red1   = scale8(red1,   f1) + scale8(entry->r, f2);
+    green1 = scale8(green1, f1) + scale8(entry->g, f2);
+    blue1  = scale8(blue1,  f1) + scale8(entry->b, f2);
+  }
+  if (brightness != 255) {
+    if (brightness) {
+      ++brightness;
+      red1 = scale8(red1, brightness); green1 = scale8(green1, brightness); blue1 = scale8(blue1, brightness);
+    } else {
+      red1 = green1 = blue1 = 0;
+    }
+  }
+  return CRGB(red1, green1, blue1);
+}
+
+void nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges) {
+  uint8_t *p1 = (uint8_t *)current.entries;
+  uint8_t *p2 = (uint8_t *)target.entries;
+  uint8_t changes = 0;
+  for (unsigned i = 0; i < sizeof(current.entries); ++i) {
+    if (p1[i] == p2[i]) continue;
+    if (p1[i] < p2[i]) { ++p1[i]; ++changes; }
+    if (p1[i] > p2[i]) { --p1[i]; ++changes; if (p1[i] > p2[i]) --p1[i]; }
+    if (changes >= maxChanges) break;
+  }
+}
+
+const TProgmemRGBPalette16 CloudColors_p = {
+  0x0000FF, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B,
+  0x0000FF, 0x00008B, 0x87CEEB, 0x87CEEB, 0xADD8E6, 0xFFFFFF, 0xADD8E6, 0x87CEEB
+};
+const TProgmemRGBPalette16 LavaColors_p = {
+  0x000000, 0x800000, 0x000000, 0x800000, 0x8B0000, 0x8B0000, 0x800000, 0x8B0000,
+  0x8B0000, 0x8B0000, 0xFF0000, 0xFFA500, 0xFFFFFF, 0xFFA500, 0xFF0000, 0x8B0000
+};
+const TProgmemRGBPalette16 OceanColors_p = {
+  0x191970, 0x00008B, 0x191970, 0x000080, 0x00008B, 0x0000CD, 0x2E8B57, 0x008080,
+  0x5F9EA0, 0x0000FF, 0x008B8B, 0x6495ED, 0x7FFFD4, 0x2E8B57, 0x00FFFF, 0x87CEFA
+};
+const TProgmemRGBPalette16 ForestColors_p = {
+  0x006400, 0x006400, 0x556B2F, 0x006400, 0x008000, 0x228B22, 0x6B8E23, 0x008000,
+  0x2E8B57, 0x66CDAA, 0x32CD32, 0x9ACD32, 0x90EE90, 0x7CFC00, 0x66CDAA, 0x228B22
+};
+const TProgmemRGBPalette16 RainbowColors_p = {
+  0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+  0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B
+};
+const TProgmemRGBPalette16 RainbowStripeColors_p = {
+  0xFF0000, 0x000000, 0xAB5500, 0x000000, 0xABAB00, 0x000000, 0x00FF00, 0x000000,
+  0x00AB55, 0x000000, 0x0000FF, 0x000000, 0x5500AB, 0x000000, 0xAB0055, 0x000000
+};
+const TProgmemRGBPalette16 PartyColors_p = {
+  0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+  0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+const TProgmemRGBPalette16 HeatColors_p = {
+  0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+  0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF
+};
@@ -0,0 +1,13 @@
+#pragma once
+// LEDC register block replacement; written by BusPwm::show()
+#include <stdint.h>
+
+typedef struct {
+  struct {
+    struct {
+      struct { uint32_t hpoint; } hpoint;
+      struct { uint32_t duty; } duty;
+    } channel[8];
+  } channel_group[2];
+} ledc_dev_t;
+extern ledc_dev_t LEDC;
@@ -0,0 +1,112 @@
+#pragma once
+/*
+ * Force-included into every host translation unit (-include wled_host.h).
+ *
+ * Stands in for wled.h: pulls in the render core headers and declares the globals the render core uses,
+ * without the network, file system and web server stacks wled.h drags in.
+ * bus_wrapper.h (NeoPixelBus) is replaced by an in-memory PolyBus (see polybus_host.h).
+ */
+
+#define WLED_H
+#define BusWrapper_h
+#define ASYNC_JSON_H_
+
+#define WLED_DISABLE_ALEXA
+#define WLED_DISABLE_MQTT
+#define WLED_DISABLE_ESPNOW
+#define WLED_DISABLE_INFRARED
+#define WLED_DISABLE_HUESYNC
+#define WLED_DISABLE_LOXONE
+#define WLED_ENABLE_FS_EDITOR
+
+#ifdef __cplusplus
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+// forward declarations for types only used by pointer/reference in fcn_declare.h
+class AsyncWebServerRequest;
+class AsyncWebSocket;
+class AsyncWebSocketClient;
+class AsyncClient;
+typedef int AwsEventType;
+typedef int WiFiEvent_t;
+union e131_packet_t;
+struct ArtPollReply;
+
+#define ARDUINOJSON_DECODE_UNICODE 0
+#include "src/dependencies/json/ArduinoJson-v6.h"
+#define PSRAMDynamicJsonDocument DynamicJsonDocument
+
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+#include "const.h"
+#include "fcn_declare.h"
+#include "pin_manager.h"
+#include "bus_manager.h"
+#include "polybus_host.h"
+#include "FX.h"
+#include "perf.h"
+
+#define WLED_GLOBAL extern
+#define _INIT(x)
+#define _INIT_N(x)
+#define _INIT_PROGMEM(x)
+
+#define DEBUG_PRINT(x)
+#define DEBUG_PRINTLN(x)
+#define DEBUG_PRINTF(x...)
+#define DEBUG_PRINTF_P(x...)
+#define DEBUGFS_PRINT(x)
+#define DEBUGFS_PRINTLN(x)
+#define DEBUGFS_PRINTF(x...)
+
+#define SET_F(x)  (const char*)F(x)
+#define RGBW32(r,g,b,w) (uint32_t((byte(w) << 24) | (byte(r) << 16) | (byte(g) << 8) | (byte(b))))
+#define R(c) (byte((c) >> 16))
+#define G(c) (byte((c) >> 8))
+#define B(c) (byte(c))
+#define W(c) (byte((c) >> 24))
+
+#include "src/dependencies/time/TimeLib.h"
+#include "host_fs.h"
+#define WLED_FS HostFS
+
+// globals from wled.h used by the render core (defined in host_globals.cpp)
+extern WS2812FX strip;
+extern JsonDocument *pDoc;
+extern volatile uint8_t jsonBufferLock;
+extern SemaphoreHandle_t jsonBufferLockMutex;
+extern byte briT;
+extern bool useGlobalLedBuffer;
+extern uint8_t currentLedmap;
+extern byte errorFlag;
+extern byte lastRandomIndex;
+extern bool fadeTransition;
+extern bool modeBlending;
+extern uint8_t blendingStyle;
+extern uint16_t transitionDelay;
+extern uint8_t randomPaletteChangeTime;
+extern bool useHarmonicRandomPalette;
+extern bool stateChanged;
+extern byte interfaceUpdateCallMode;
+extern String escapedMac;
+extern time_t localTime;
+extern bool useAMPM;
+extern char *ledmapNames[WLED_MAX_LEDMAPS-1];
+extern uint32_t ledMaps;
+extern bool gammaCorrectCol;
+extern bool gammaCorrectBri;
+extern float gammaCorrectVal;
+extern bool cctICused;
+extern bool psramSafe;
+extern bool realtimeRespectLedMaps;
+extern byte realtimeMode;
+extern byte realtimeOverride;
+extern bool correctPIN;
+extern char settingsPIN[5];
+extern unsigned long lastEditTime;
+extern char serverDescription[33];
+extern char cmDNS[33];
+
+#endif
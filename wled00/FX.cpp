@@ -5116,7 +5116,8 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
   const int cols = SEGMENT.virtualWidth();
   const int rows = SEGMENT.virtualHeight();
   const unsigned dataSize = sizeof(CRGB) * SEGMENT.length();  // using width*height prevents reallocation if mirroring is enabled
-  const int crcBufferLen = 2; //(SEGMENT.width() + SEGMENT.height())*71/100; // roughly sqrt(2)/2 for better repetition detection (Ewowi)
+  const int crcBufferLen = 16; // detects still lifes and oscillators up to period 16 (pulsar: 3, pentadecathlon: 15)
+  const unsigned maxGenerations = 8 * max(cols, rows); // long cycles (i.e. glider wrapping around) end after a glider crossed segment twice
 
   if (!SEGENV.allocateData(dataSize + sizeof(uint16_t)*crcBufferLen)) return mode_static(); //allocation failed
   CRGB *prevLeds = reinterpret_cast<CRGB*>(SEGENV.data);
@@ -5127,6 +5128,7 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
   if (SEGENV.call == 0 || strip.now - SEGMENT.step > 3000) {
     SEGENV.step = strip.now;
     SEGENV.aux0 = 0;
+    SEGENV.aux1 = 0; // generation
     //random16_set_seed(millis()>>2); //seed the random generator
 
     //give the leds random state and colors (based on intensity, colors from palette or all posible colors are chosen)
@@ -5146,8 +5148,12 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
   }
 
   //copy previous leds (save previous generation)
-  //NOTE: using lossy getPixelColor() is a benefit as endlessly repeating patterns will eventually fade out causing a reset
-  for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) prevLeds[XY(x,y)] = SEGMENT.getPixelColorXY(x,y);
+  //NOTE: segment pixel buffer is lossless, repeating patterns no longer fade out; the CRC check and generation cap below reset them
+  uint32_t rowPx[cols];
+  for (int y = 0; y < rows; y++) {
+    SEGMENT.getPixelSpan(0, y, rowPx, cols);
+    for (int x = 0; x < cols; x++) prevLeds[XY(x,y)] = rowPx[x];
+  }
 
   //calculate new leds
   for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) {
@@ -5203,6 +5209,8 @@ uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https:
   bool repetition = false;
   for (int i=0; i<crcBufferLen && !repetition; i++) repetition = (crc == crcBuffer[i]); // (Ewowi)
   // same CRC would mean image did not change or was repeating itself
+  if (SEGENV.aux1 < maxGenerations) SEGENV.aux1++;
+  else repetition = true; // game too long, cycle longer than CRC buffer
   if (!repetition) SEGENV.step = strip.now; //if no repetition avoid reset
   // remember CRCs across frames
   crcBuffer[SEGENV.aux0] = crc;
@@ -7421,11 +7429,7 @@ uint16_t mode_2DFunkyPlank(void) {              // Written by ??? Adapted by Wil
     }
 
     // Update the display:
-    for (int i = (rows - 1); i > 0; i--) {
-      for (int j = (cols - 1); j >= 0; j--) {
-        SEGMENT.setPixelColorXY(j, i, SEGMENT.getPixelColorXY(j, i-1));
-      }
-    }
+    SEGMENT.moveY(-1); // scroll down, keeps top row
   }
 
   return FRAMETIME;
@@ -7648,10 +7652,12 @@ uint16_t mode_2Dsoap() {
   int amplitude;
   int shiftX = 0; //(SEGMENT.custom1 - 128) / 4;
   int shiftY = 0; //(SEGMENT.custom2 - 128) / 4;
-  CRGB ledsbuff[MAX(cols,rows)];
+  uint32_t ledsbuff[MAX(cols,rows)];
+  uint32_t pxbuff[MAX(cols,rows)];
 
   amplitude = (cols >= 16) ? (cols-8)/8 : 1;
   for (int y = 0; y < rows; y++) {
+    SEGMENT.getPixelSpan(0, y, pxbuff, cols);
     int amount   = ((int)noise3d[XY(0,y)] - 128) * 2 * amplitude + 256*shiftX;
     int delta    = abs(amount) >> 8;
     int fraction = abs(amount) & 255;
@@ -7664,18 +7670,20 @@ uint16_t mode_2Dsoap() {
         zF = zD + 1;
       }
       CRGB PixelA = CRGB::Black;
-      if ((zD >= 0) && (zD < cols)) PixelA = SEGMENT.getPixelColorXY(zD, y);
+      if ((zD >= 0) && (zD < cols)) PixelA = pxbuff[zD];
       else                          PixelA = ColorFromPalette(SEGPALETTE, ~noise3d[XY(abs(zD),y)]*3);
       CRGB PixelB = CRGB::Black;
-      if ((zF >= 0) && (zF < cols)) PixelB = SEGMENT.getPixelColorXY(zF, y);
+      if ((zF >= 0) && (zF < cols)) PixelB = pxbuff[zF];
       else                          PixelB = ColorFromPalette(SEGPALETTE, ~noise3d[XY(abs(zF),y)]*3);
-      ledsbuff[x] = (PixelA.nscale8(ease8InOutApprox(255 - fraction))) + (PixelB.nscale8(ease8InOutApprox(fraction)));
+      CRGB c = (PixelA.nscale8(ease8InOutApprox(255 - fraction))) + (PixelB.nscale8(ease8InOutApprox(fraction)));
+      ledsbuff[x] = RGBW32(c.r, c.g, c.b, 0);
     }
-    for (int x = 0; x < cols; x++) SEGMENT.setPixelColorXY(x, y, ledsbuff[x]);
+    SEGMENT.setPixelSpan(0, y, ledsbuff, cols);
   }
 
   amplitude = (rows >= 16) ? (rows-8)/8 : 1;
   for (int x = 0; x < cols; x++) {
+    SEGMENT.getPixelSpan(x, 0, pxbuff, rows, true);
     int amount   = ((int)noise3d[XY(x,0)] - 128) * 2 * amplitude + 256*shiftY;
     int delta    = abs(amount) >> 8;
     int fraction = abs(amount) & 255;
@@ -7688,14 +7696,15 @@ uint16_t mode_2Dsoap() {
         zF = zD + 1;
       }
       CRGB PixelA = CRGB::Black;
-      if ((zD >= 0) && (zD < rows)) PixelA = SEGMENT.getPixelColorXY(x, zD);
+      if ((zD >= 0) && (zD < rows)) PixelA = pxbuff[zD];
       else                          PixelA = ColorFromPalette(SEGPALETTE, ~noise3d[XY(x,abs(zD))]*3); 
       CRGB PixelB = CRGB::Black;
-      if ((zF >= 0) && (zF < rows)) PixelB = SEGMENT.getPixelColorXY(x, zF);
+      if ((zF >= 0) && (zF < rows)) PixelB = pxbuff[zF];
       else                          PixelB = ColorFromPalette(SEGPALETTE, ~noise3d[XY(x,abs(zF))]*3);
-      ledsbuff[y] = (PixelA.nscale8(ease8InOutApprox(255 - fraction))) + (PixelB.nscale8(ease8InOutApprox(fraction)));
+      CRGB c = (PixelA.nscale8(ease8InOutApprox(255 - fraction))) + (PixelB.nscale8(ease8InOutApprox(fraction)));
+      ledsbuff[y] = RGBW32(c.r, c.g, c.b, 0);
     }
-    for (int y = 0; y < rows; y++) SEGMENT.setPixelColorXY(x, y, ledsbuff[y]);
+    SEGMENT.setPixelSpan(x, 0, ledsbuff, rows, true);
   }
 
   return FRAMETIME;
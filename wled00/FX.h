@@ -73,6 +73,31 @@
   #endif
 #endif
 
+/* Size of effect data arena (a single heap block holding effect data of all segments and, if there is room,
+  copies of effect data kept during transitions). Data that does not fit is allocated on heap. */
+#ifndef DATA_ARENA_SIZE
+  #ifdef ESP8266
+    #define DATA_ARENA_SIZE (MAX_SEGMENT_DATA/2 + 8*MAX_NUM_SEGMENTS) // 2.6k, released when no effect uses it
+  #else
+    #define DATA_ARENA_SIZE (MAX_SEGMENT_DATA/2 + 8*MAX_NUM_SEGMENTS) // 20k by default
+  #endif
+#endif
+
+/* Number of decoded palettes kept in LRU cache (gradient and color based palettes). */
+#ifndef PALETTE_CACHE_SIZE
+  #ifdef ESP8266
+    #define PALETTE_CACHE_SIZE 4
+  #else
+    #define PALETTE_CACHE_SIZE 8
+  #endif
+#endif
+
+/* Expand active palette into 256 entry lookup table used by color_from_palette() (768 bytes of RAM). */
+#if !defined(ESP8266) && !defined(WLED_DISABLE_PALETTE_LUT)
+  #define WLED_PALETTE_LUT
+#endif
+#define PALETTE_LUT_THRESHOLD 32 // number of lookups into the same palette before the table is built
+
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
@@ -80,6 +105,12 @@
 #define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
 
 #define NUM_COLORS       3 /* number of colors per segment */
+
+/* Effect blending (transition) styles, see Segment::blendTransition() */
+#define BLEND_STYLE_FADE      0
+#define BLEND_STYLE_WIPE      1 // new effect wipes in from left
+#define BLEND_STYLE_DISSOLVE  2 // pixels switch to new effect in random order
+#define BLEND_STYLE_COUNT     3
 #define SEGMENT          strip._segments[strip.getCurrSegmentId()]
 #define SEGENV           strip._segments[strip.getCurrSegmentId()]
 //#define SEGCOLOR(x)      strip._segments[strip.getCurrSegmentId()].currentColor(x, strip._segments[strip.getCurrSegmentId()].colors[x])
@@ -372,8 +403,23 @@ typedef struct Segment {
     uint16_t aux0;  // custom var
     uint16_t aux1;  // custom var
     byte     *data; // effect data pointer
+    uint32_t *pixels; // segment pixel buffer (virtual pixels, brightness not applied), composited onto strip by WS2812FX::blendSegment()
+    // frame scheduler data, maintained by WS2812FX::service()
+    struct {
+      uint16_t cost;    // effect render time in us (moving average)
+      uint16_t delay;   // additional frame delay in ms (reduces fps while frame budget is exceeded)
+      uint16_t missed;  // deadlines missed (rendering postponed to next frame because of frame budget)
+      uint8_t  frames;  // frames rendered in current second
+      uint8_t  fps;     // frames rendered in last second
+    } sched;
     static uint16_t maxWidth, maxHeight;  // these define matrix width & height (max. segment dimensions)
 
+    // precomputed mapping of a virtual pixel (index into pixels[]) to a physical strip pixel (ledmap applied)
+    typedef struct PixelMap {
+      uint16_t v;   // virtual pixel
+      uint16_t p;   // physical pixel
+    } pxmap_t;
+
     typedef struct TemporarySegmentData {
       uint16_t _optionsT;
       uint32_t _colorT[NUM_COLORS];
@@ -398,6 +444,13 @@ typedef struct Segment {
       {}
     } tmpsegd_t;
 
+    typedef struct DataArenaInfo {
+      uint16_t size;        // arena size (0 if not allocated)
+      uint16_t used;        // bytes used by blocks (including headers)
+      uint16_t largest;     // largest free block
+      uint16_t compactions; // number of compactions since boot
+    } arenainfo_t;
+
   private:
     union {
       uint8_t  _capabilities;
@@ -410,7 +463,36 @@ typedef struct Segment {
       };
     };
     uint16_t        _dataLen;
+    uint16_t        _pixelsLen;       // number of virtual pixels in pixels[]
+    uint32_t       *_pixelsStaged;    // pixels set through JSON API ("i"), copied into pixels[] by applyStagedPixels()
+    uint16_t        _pixelsStagedLen; // number of virtual pixels in _pixelsStaged[]
+    pxmap_t        *_map;             // virtual to physical index table (in drawing order), see updateMap()
+    uint16_t        _mapLen;          // number of entries in _map[]
+    uint16_t        _mapFirst;        // lowest physical pixel in _map[]
+    uint16_t        _mapLast;         // highest physical pixel in _map[]
+    uint8_t         _mapGen;          // ledmap generation _map[] was built for
+    uint32_t        _mapKey[3];       // segment geometry & options _map[] was built for
+    uint16_t       *_m12Map;          // 1D to 2D expansion table (arc & pinwheel), see updateMap1D2D()
+    uint16_t        _m12Len;          // number of entries in _m12Map[]
+    uint16_t        _m12Rays;         // number of 1D pixels in _m12Map[]
+    uint8_t         _m12Mode;         // map1D2D _m12Map[] was built for
+    uint32_t        _m12Key;          // virtual dimensions _m12Map[] was built for
+
+    // per-frame render context, captured by WS2812FX::service() so that all pixels (and all effect calls)
+    // within a frame see the same transition progress, brightness and colors
+    struct {
+      uint16_t progress;           // transition progress
+      uint8_t  bri;                // blended opacity
+      uint8_t  cct;                // blended CCT
+      uint32_t colors[NUM_COLORS]; // blended colors
+      bool     hasProgress : 1;    // progress is valid
+      bool     hasValues   : 1;    // bri, cct & colors are valid
+    } _frame;
     static uint16_t _usedSegmentData;
+    static uint8_t *_dataArena;         // effect data arena (see DATA_ARENA_SIZE)
+    static uint8_t  _arenaBlocks;       // number of used blocks in arena
+    static uint16_t _arenaCompactions;  // number of arena compactions since boot
+    static bool     _arenaFragmented;   // allocation failed although arena had enough free space
 
     // perhaps this should be per segment, not static
     static CRGBPalette16 _currentPalette;     // palette used for current effect (includes transition, used in color_from_palette())
@@ -418,15 +500,53 @@ typedef struct Segment {
     static CRGBPalette16 _newRandomPalette;   // target random palette
     static uint16_t _lastPaletteChange;       // last random palette change time in millis()/1000
     static uint16_t _lastPaletteBlend;        // blend palette according to set Transition Delay in millis()%0xFFFF
+    typedef struct PaletteCacheEntry {
+      CRGBPalette16 palette;  // decoded palette
+      uint32_t      key[3];   // gamma corrected segment colors used by palette (0 if unused)
+      uint16_t      lastUsed; // LRU stamp
+      uint8_t       id;       // palette id (0 = unused entry)
+    } palcache_t;
+    static palcache_t _paletteCache[PALETTE_CACHE_SIZE];
+    static uint16_t   _paletteCacheTick;
+    #ifdef WLED_PALETTE_LUT
+    static CRGB       _paletteLUT[256];       // _currentPalette expanded (valid if _paletteLUTValid)
+    static CRGBPalette16 _paletteLUTSrc;      // palette from which _paletteLUT was built
+    static uint8_t    _paletteLUTHits;        // lookups since _currentPalette changed (LUT is built at PALETTE_LUT_THRESHOLD)
+    static bool       _paletteLUTValid;
+    static bool       _paletteLUTNoBlend;     // LUT was built without interpolation (paletteBlend == 3)
+    #endif
     #ifndef WLED_DISABLE_MODE_BLEND
     static bool          _modeBlend;          // mode/effect blending semaphore
     #endif
 
+    void copyPixels(const Segment &orig); // duplicates pixel buffer of orig
+    static void *allocateArena(size_t len); // allocates block in effect data arena (nullptr if it does not fit)
+    static void  freeArena(void *p);        // releases block in effect data arena
+    static bool  inArena(const void *p);    // true if p points into effect data arena
+    static bool  relocateData(byte *from, byte *to); // updates references to effect data block (false if there are none)
+    void getMapKey(uint32_t *key) const;  // packs segment geometry & options that affect _map[]
+    #ifndef WLED_DISABLE_2D
+    bool setPixelColor1D2D(int i, uint32_t c, int vW, int vH, bool jump = false); // sets arc/pinwheel pixel using _m12Map[] (false if not available)
+    #endif
+    uint32_t *clipSpan(int x, int y, int &len, int &skip, bool vertical, unsigned &stride) const; // clips span to segment, returns its first pixel in pixels[]
+    void      blurSpan(uint32_t *px, int len, unsigned stride, uint8_t keep, uint8_t seep); // blurs span of pixels in place
+    void      blurLine(int x, int y, int len, bool vertical, uint8_t keep, uint8_t seep); // blurs row/column (in pixel buffer or on strip)
+    int       spanIndex(int x, int y, int i, bool vertical) const; // pixel buffer index of i-th span pixel (-1 if outside segment)
+    void      setPixelColorDirect(unsigned v, uint32_t col) const; // draws onto strip (no pixel buffer)
+    uint32_t  getPixelColorDirect(unsigned v) const;                // reads from strip (no pixel buffer)
+    inline void setSpanPixel(uint32_t *px, uint32_t c) { // sets pixel within span (blends with underlying pixel if blending modes)
+      #ifndef WLED_DISABLE_MODE_BLEND
+      if (_modeBlend) c = color_blend(*px, c, 0xFFFFU - progress(), true);
+      #endif
+      *px = c;
+    }
+
     // transition data, valid only if transitional==true, holds values during transition (72 bytes)
     struct Transition {
       #ifndef WLED_DISABLE_MODE_BLEND
       tmpsegd_t     _segT;        // previous segment environment
       uint8_t       _modeT;       // previous mode/effect
+      uint32_t     *_pixelsT;     // pixel buffer of previous mode/effect (nullptr: previous effect draws over new one)
       #else
       uint32_t      _colorT[NUM_COLORS];
       #endif
@@ -441,9 +561,18 @@ typedef struct Segment {
         , _prevPaletteBlends(0)
         , _start(millis())
         , _dur(dur)
-      {}
+      {
+        #ifndef WLED_DISABLE_MODE_BLEND
+        _pixelsT = nullptr;
+        #endif
+      }
     } *_t;
 
+    static Transition *_transitionPool;     // preallocated transitions (one per segment), allocated with first transition
+    static uint8_t     _transitionsUsed[(MAX_NUM_SEGMENTS+7)/8];
+    static Transition *newTransition(uint16_t dur);  // takes transition from pool (or heap if pool is not available)
+    static void        deleteTransition(Transition *t);
+
   public:
 
     Segment(uint16_t sStart=0, uint16_t sStop=30) :
@@ -475,8 +604,25 @@ typedef struct Segment {
       aux0(0),
       aux1(0),
       data(nullptr),
+      pixels(nullptr),
+      sched{},
       _capabilities(0),
       _dataLen(0),
+      _pixelsLen(0),
+      _pixelsStaged(nullptr),
+      _pixelsStagedLen(0),
+      _map(nullptr),
+      _mapLen(0),
+      _mapFirst(0),
+      _mapLast(0),
+      _mapGen(0),
+      _mapKey{0,0,0}, // never matches an active segment
+      _m12Map(nullptr),
+      _m12Len(0),
+      _m12Rays(0),
+      _m12Mode(0),
+      _m12Key(0),     // never matches an active segment
+      _frame{},
       _t(nullptr)
     {
       #ifdef WLED_DEBUG
@@ -502,13 +648,17 @@ typedef struct Segment {
       if (name) { delete[] name; name = nullptr; }
       stopTransition();
       deallocateData();
+      deallocatePixels();
+      discardStagedPixels();
+      deallocateMap();
+      deallocateMap1D2D();
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
     Segment& operator= (Segment &&orig) noexcept; // move assignment
 
 #ifdef WLED_DEBUG
-    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
+    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (pixels?_pixelsLen*sizeof(uint32_t):0) + (_map?_mapLen*sizeof(pxmap_t):0) + (_m12Map?_m12Len*sizeof(uint16_t):0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
 #endif
 
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
@@ -516,6 +666,7 @@ typedef struct Segment {
     inline bool     isInTransition()     const { return _t != nullptr; }
     inline bool     isActive()           const { return stop > start; }
     inline bool     is2D()               const { return (width()>1 && height()>1); }
+    inline bool     inMatrix()           const { return Segment::maxHeight>1 && start < Segment::maxWidth*Segment::maxHeight; } // segment (2D or 1D) is part of matrix
     inline bool     hasRGB()             const { return _isRGB; }
     inline bool     hasWhite()           const { return _hasW; }
     inline bool     isCCT()              const { return _isCCT; }
@@ -547,7 +698,25 @@ typedef struct Segment {
     inline uint16_t dataSize() const { return _dataLen; }
     bool allocateData(size_t len);  // allocates effect data buffer in heap and clears it
     void deallocateData();          // deallocates (frees) effect data buffer from heap
+    static void compactData();      // moves effect data blocks together to remove arena fragmentation (only if needed), releases unused arena on ESP8266
+    static void getArenaInfo(arenainfo_t &info); // effect data arena usage
     void resetIfRequired();         // sets all SEGENV variables to 0 and clears data buffer
+    bool allocatePixels();          // (re)allocates pixel buffer to match virtual segment dimensions
+    void deallocatePixels();        // deallocates (frees) pixel buffer
+    inline uint16_t pixelsSize() const { return _pixelsLen; } // number of virtual pixels in pixel buffer
+    unsigned bufferLength() const;  // number of virtual pixels a pixel buffer needs for current geometry
+    uint32_t *newStagedPixels(bool keep) const; // allocates bufferLength() pixels to stage, filled with current pixels (keep) or black
+    void stagePixels(uint32_t *px, unsigned len); // hands pixels from newStagedPixels() over to WS2812FX::service() (may be called from any task)
+    void applyStagedPixels();       // copies staged pixels into pixel buffer, must only be called from loop() after allocatePixels()
+    void discardStagedPixels();     // deallocates (frees) staged pixels
+    bool updateMap();               // (re)builds virtual to physical index table if geometry, options or ledmap changed
+    void deallocateMap();           // deallocates (frees) index table
+    const pxmap_t *getMap() const;  // returns index table if it matches current geometry (nullptr otherwise)
+    inline uint16_t mapSize() const { return _mapLen; } // number of entries in index table
+    inline uint16_t mapFirst() const { return _mapFirst; } // physical pixel range covered by index table
+    inline uint16_t mapLast() const { return _mapLast; }
+    bool updateMap1D2D();           // (re)builds arc/pinwheel 1D to 2D expansion table if expansion or dimensions changed
+    void deallocateMap1D2D();       // deallocates (frees) 1D to 2D expansion table
     /**
       * Flags that before the next effect is calculated,
       * the internal segment state should be reset.
@@ -563,7 +732,13 @@ typedef struct Segment {
     #ifndef WLED_DISABLE_MODE_BLEND
     void     swapSegenv(tmpsegd_t &tmpSegD);    // copies segment data into specifed buffer, if buffer is not a transition buffer, segment data is overwritten from transition buffer
     void     restoreSegenv(tmpsegd_t &tmpSegD); // restores segment data from buffer, if buffer is not transition buffer, changed values are copied to transition buffer
+    bool     allocateTransitionPixels();        // allocates pixel buffer for previous mode/effect (copy of current one) if not yet allocated
+    void     swapTransitionPixels();            // swaps pixel buffer with the one of previous mode/effect
+    bool     hasTransitionPixels() const;       // true if previous mode/effect is blended from its own pixel buffer
+    void     blendTransition(uint32_t *dst) const; // composes pixel buffers of current and previous mode/effect into dst (using blendingStyle)
     #endif
+    void     beginFrame(unsigned long t);       // captures per-frame render context (transition progress at time t, brightness & colors)
+    inline void endFrame() { _frame.hasProgress = _frame.hasValues = false; } // outside of frame values are calculated on each call
     [[gnu::hot]] uint16_t progress() const;                  // transition progression between 0-65535
     [[gnu::hot]] uint8_t  currentBri(bool useCct = false) const; // current segment brightness/CCT (blended while in transition)
     uint8_t  currentMode() const;                            // currently active effect/mode (while in transition)
@@ -583,6 +758,11 @@ typedef struct Segment {
     inline void setPixelColor(float i, CRGB c, bool aa = true)                                         { setPixelColor(i, RGBW32(c.r,c.g,c.b,0), aa); }
     #endif
     [[gnu::hot]] uint32_t getPixelColor(int i) const;
+    // span (bulk) access: a span runs along a row (or a column if vertical) of virtual pixels starting at (x,y)
+    // it is clipped to the segment once instead of for every pixel; 1D segments consist of a single row (y=0)
+    int  getPixelSpan(int x, int y, uint32_t *buf, int len, bool vertical = false) const; // pixels outside segment are black, returns number of pixels within segment
+    void setPixelSpan(int x, int y, const uint32_t *buf, int len, bool vertical = false);
+    void fillSpan(int x, int y, int len, uint32_t c, bool vertical = false);
     // 1D support functions (some implement 2D as well)
     void blur(uint8_t, bool smear = false);
     void fill(uint32_t c);
@@ -737,19 +917,29 @@ class WS2812FX {  // 96 bytes
       _brightness(DEFAULT_BRIGHTNESS),
       _transitionDur(750),
       _targetFps(WLED_FPS),
+      _frameBudget(100),
       _frametime(FRAMETIME_FIXED),
       _cumulativeFps(50 << FPS_CALC_SHIFT),
       _isServicing(false),
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
       _triggered(false),
+      _showPending(false),
+      _showBusy(false),
       _modeCount(MODE_COUNT),
       _callback(nullptr),
       customMappingTable(nullptr),
       customMappingSize(0),
+      _mapGeneration(0),
       _lastShow(0),
+      _showStart(0),
+      _showDone(0),
+      _schedSecond(0),
+      _renderTime(0),
       _segment_index(0),
-      _mainSegment(0)
+      _mainSegment(0),
+      _pixelsBlend(nullptr),
+      _pixelsBlendLen(0)
     {
       WS2812FX::instance = this;
       _mode.reserve(_modeCount);     // allocate memory to prevent initial fragmentation (does not increase size())
@@ -760,6 +950,7 @@ class WS2812FX {  // 96 bytes
 
     ~WS2812FX() {
       if (customMappingTable) delete[] customMappingTable;
+      if (_pixelsBlend) free(_pixelsBlend);
       _mode.clear();
       _modeData.clear();
       _segments.clear();
@@ -789,8 +980,11 @@ class WS2812FX {  // 96 bytes
       makeAutoSegments(bool forceReset = false),  // will create segments based on configured outputs
       fixInvalidSegments(),                       // fixes incorrect segment configuration
       setPixelColor(unsigned n, uint32_t c),      // paints absolute strip pixel with index n and color c
+      setPixels(unsigned start, unsigned count, const uint32_t *c, bool raw = false), // paints count absolute strip pixels starting at start (raw: no color correction)
+      blendSegment(const Segment &seg),           // composites segment's pixel buffer onto the strip
       show(),                                     // initiates LED output
       setTargetFps(uint8_t fps),
+      setFrameBudget(uint8_t pct),
       setupEffectData();                          // add default effects to the list; defined in FX.cpp
 
     inline void resetTimebase()           { timebase = 0UL - millis(); }
@@ -837,23 +1031,29 @@ class WS2812FX {  // 96 bytes
     inline uint8_t getMainSegmentId() const { return _mainSegment; }      // returns main segment index
     inline uint8_t getPaletteCount() const  { return 13 + GRADIENT_PALETTE_COUNT + customPalettes.size(); }
     inline uint8_t getTargetFps() const     { return _targetFps; }        // returns rough FPS value for las 2s interval
+    inline uint8_t getFrameBudget() const   { return _frameBudget; }      // returns % of frame time effects may use (0 = unlimited)
     inline uint8_t getModeCount() const     { return _modeCount; }        // returns number of registered modes/effects
 
     uint16_t
       getLengthPhysical() const,
       getLengthTotal() const, // will include virtual/nonexistent pixels in matrix
       getFps() const,
-      getMappedPixelIndex(uint16_t index) const;
+      getMappedPixelIndex(uint16_t index) const,
+      renderSegment(uint8_t n);                   // runs effect of segment n into its pixel buffer, returns frame delay
 
     inline uint16_t getFrameTime() const    { return _frametime; }        // returns amount of time a frame should take (in ms)
+    inline uint32_t getFrameBudgetUs() const { return _frametime * 10UL * _frameBudget; } // returns time effects may use per frame (in us, 0 = unlimited)
+    inline uint32_t getRenderTime() const   { return _renderTime; }       // returns time effects used in last frame (in us)
     inline uint16_t getMinShowDelay() const { return MIN_SHOW_DELAY; }    // returns minimum amount of time strip.service() can be delayed (constant)
     inline uint16_t getLength() const       { return _length; }           // returns actual amount of LEDs on a strip (2D matrix may have less LEDs than W*H)
     inline uint16_t getTransition() const   { return _transitionDur; }    // returns currently set transition time (in ms)
+    inline uint8_t  getMapGeneration() const { return _mapGeneration; }   // changes whenever ledmap or matrix layout changes (invalidates segment index tables)
 
     unsigned long now, timebase;
     uint32_t getPixelColor(unsigned) const;
 
     inline uint32_t getLastShow() const       { return _lastShow; }           // returns millis() timestamp of last strip.show() call
+    inline uint32_t getLastShowDone() const   { return _showDone; }           // returns micros() timestamp when buses finished sending last frame
     inline uint32_t segColor(uint8_t i) const { return _colors_t[i]; }        // returns currently valid color (for slot i) AKA SEGCOLOR(); may be blended between two colors while in transition
 
     const char *
@@ -937,6 +1137,7 @@ class WS2812FX {  // 96 bytes
     uint16_t _transitionDur;
 
     uint8_t  _targetFps;
+    uint8_t  _frameBudget;  // % of frame time effects may use before segments are postponed/slowed down
     uint16_t _frametime;
     uint16_t _cumulativeFps;
 
@@ -946,6 +1147,8 @@ class WS2812FX {  // 96 bytes
       bool _isOffRefreshRequired : 1; //periodic refresh is required for the strip to remain off.
       bool _hasWhiteChannel      : 1;
       bool _triggered            : 1;
+      bool _showPending          : 1; // frame is composited, waiting for buses to finish sending previous one
+      bool _showBusy             : 1; // buses are sending last frame (completion not yet seen)
     };
 
     uint8_t                  _modeCount;
@@ -956,11 +1159,19 @@ class WS2812FX {  // 96 bytes
 
     uint16_t* customMappingTable;
     uint16_t  customMappingSize;
+    uint8_t   _mapGeneration;       // invalidates segment index tables
 
     unsigned long _lastShow;
+    uint32_t      _showStart;   // cycle count when last frame was handed to buses
+    uint32_t      _showDone;    // micros() when buses finished sending last frame
+    unsigned long _schedSecond; // start of current fps counting interval
+    uint32_t      _renderTime;  // time (us) effects used in last frame
 
     uint8_t _segment_index;
     uint8_t _mainSegment;
+
+    uint32_t *_pixelsBlend;     // composed pixels of segment in effect transition (shared by all segments)
+    uint16_t  _pixelsBlendLen;
 };
 
 extern const char JSON_mode_names[];
@@ -21,6 +21,7 @@
 // so matrix should disable regular ledmap processing
 void WS2812FX::setUpMatrix() {
 #ifndef WLED_DISABLE_2D
+  _mapGeneration++; // segment index tables need to be rebuilt (matrix dimensions or ledmap may change)
   // isMatrix is set in cfg.cpp or set.cpp
   if (isMatrix) {
     // calculate width dynamically because it may have gaps
@@ -156,50 +157,18 @@ uint16_t IRAM_ATTR_YN Segment::XY(int x, int y)
 void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
 {
   if (!isActive()) return; // not active
-  if ((unsigned)x >= virtualWidth() || (unsigned)y >= virtualHeight() || x<0 || y<0) return;  // if pixel would fall out of virtual segment just exit
-
-  uint8_t _bri_t = currentBri();
-  if (_bri_t < 255) {
-    col = color_fade(col, _bri_t);
-  }
-
-  if (reverse  ) x = virtualWidth()  - x - 1;
-  if (reverse_y) y = virtualHeight() - y - 1;
-  if (transpose) { std::swap(x,y); } // swap X & Y if segment transposed
-
-  x *= groupLength(); // expand to physical pixels
-  y *= groupLength(); // expand to physical pixels
-
-  int W = width();
-  int H = height();
-  if (x >= W || y >= H) return;  // if pixel would fall out of segment just exit
-
-  uint32_t tmpCol = col;
-  for (int j = 0; j < grouping; j++) {   // groupping vertically
-    for (int g = 0; g < grouping; g++) { // groupping horizontally
-      int xX = (x+g), yY = (y+j);
-      if (xX >= W || yY >= H) continue;  // we have reached one dimension's end
+  const unsigned vW = virtualWidth();
+  if ((unsigned)x >= vW || (unsigned)y >= virtualHeight() || x<0 || y<0) return;  // if pixel would fall out of virtual segment just exit
+  const unsigned i = x + y * vW;
+  if (!pixels) { setPixelColorDirect(i, col); return; } // not enough RAM for pixel buffer
+  if (i >= _pixelsLen) return; // buffer does not match geometry
 
 #ifndef WLED_DISABLE_MODE_BLEND
-      // if blending modes, blend with underlying pixel
-      if (_modeBlend) tmpCol = color_blend(strip.getPixelColorXY(start + xX, startY + yY), col, 0xFFFFU - progress(), true);
+  // if blending modes, blend with underlying pixel
+  if (_modeBlend) col = color_blend(pixels[i], col, 0xFFFFU - progress(), true);
 #endif
 
-      strip.setPixelColorXY(start + xX, startY + yY, tmpCol);
-
-      if (mirror) { //set the corresponding horizontally mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + xX, startY + height() - yY - 1, tmpCol);
-        else           strip.setPixelColorXY(start + width() - xX - 1, startY + yY, tmpCol);
-      }
-      if (mirror_y) { //set the corresponding vertically mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + width() - xX - 1, startY + yY, tmpCol);
-        else           strip.setPixelColorXY(start + xX, startY + height() - yY - 1, tmpCol);
-      }
-      if (mirror_y && mirror) { //set the corresponding vertically AND horizontally mirrored pixel
-        strip.setPixelColorXY(start + width() - xX - 1, startY + height() - yY - 1, tmpCol);
-      }
-    }
-  }
+  pixels[i] = col; // expansion onto the strip is done in WS2812FX::blendSegment()
 }
 
 #ifdef WLED_USE_AA_PIXELS
@@ -251,129 +220,35 @@ void Segment::setPixelColorXY(float x, float y, uint32_t col, bool aa)
 // returns RGBW values of pixel
 uint32_t IRAM_ATTR_YN Segment::getPixelColorXY(int x, int y) const {
   if (!isActive()) return 0; // not active
-  if ((unsigned)x >= virtualWidth() || (unsigned)y >= virtualHeight() || x<0 || y<0) return 0;  // if pixel would fall out of virtual segment just exit
-  if (reverse  ) x = virtualWidth()  - x - 1;
-  if (reverse_y) y = virtualHeight() - y - 1;
-  if (transpose) { std::swap(x,y); } // swap X & Y if segment transposed
-  x *= groupLength(); // expand to physical pixels
-  y *= groupLength(); // expand to physical pixels
-  if (x >= width() || y >= height()) return 0;
-  return strip.getPixelColorXY(start + x, startY + y);
+  const unsigned vW = virtualWidth();
+  if ((unsigned)x >= vW || (unsigned)y >= virtualHeight() || x<0 || y<0) return 0;  // if pixel would fall out of virtual segment just exit
+  const unsigned i = x + y * vW;
+  if (!pixels) return getPixelColorDirect(i);
+  if (i >= _pixelsLen) return 0;
+  return pixels[i];
 }
 
 // blurRow: perform a blur on a row of a rectangular matrix
 void Segment::blurRow(uint32_t row, fract8 blur_amount, bool smear){
   if (!isActive() || blur_amount == 0) return; // not active
-  const unsigned cols = virtualWidth();
-  const unsigned rows = virtualHeight();
-
-  if (row >= rows) return;
-  // blur one row
-  uint8_t keep = smear ? 255 : 255 - blur_amount;
-  uint8_t seep = blur_amount >> 1;
-  uint32_t carryover = BLACK;
-  uint32_t lastnew;
-  uint32_t last;
-  uint32_t curnew = BLACK;
-  for (unsigned x = 0; x < cols; x++) {
-    uint32_t cur = getPixelColorXY(x, row);
-    uint32_t part = color_fade(cur, seep);
-    curnew = color_fade(cur, keep);
-    if (x > 0) {
-      if (carryover)
-        curnew = color_add(curnew, carryover, true);
-      uint32_t prev = color_add(lastnew, part, true);
-      if (last != prev) // optimization: only set pixel if color has changed
-        setPixelColorXY(x - 1, row, prev);
-    } else // first pixel
-      setPixelColorXY(x, row, curnew);
-    lastnew = curnew;
-    last = cur; // save original value for comparison on next iteration
-    carryover = part;
-  }
-  setPixelColorXY(cols-1, row, curnew); // set last pixel
+  blurLine(0, row, virtualWidth(), false, smear ? 255 : 255 - blur_amount, blur_amount >> 1);
 }
 
 // blurCol: perform a blur on a column of a rectangular matrix
 void Segment::blurCol(uint32_t col, fract8 blur_amount, bool smear) {
   if (!isActive() || blur_amount == 0) return; // not active
-  const unsigned cols = virtualWidth();
-  const unsigned rows = virtualHeight();
-
-  if (col >= cols) return;
-  // blur one column
-  uint8_t keep = smear ? 255 : 255 - blur_amount;
-  uint8_t seep = blur_amount >> 1;
-  uint32_t carryover = BLACK;
-  uint32_t lastnew;
-  uint32_t last;
-  uint32_t curnew = BLACK;
-  for (unsigned y = 0; y < rows; y++) {
-    uint32_t cur = getPixelColorXY(col, y);
-    uint32_t part = color_fade(cur, seep);
-    curnew = color_fade(cur, keep);
-    if (y > 0) {
-      if (carryover)
-        curnew = color_add(curnew, carryover, true);
-      uint32_t prev = color_add(lastnew, part, true);      
-      if (last != prev) // optimization: only set pixel if color has changed
-        setPixelColorXY(col, y - 1, prev);
-    } else // first pixel
-      setPixelColorXY(col, y, curnew);
-    lastnew = curnew;
-    last = cur; //save original value for comparison on next iteration
-    carryover = part;        
-  }
-  setPixelColorXY(col, rows - 1, curnew);
+  blurLine(col, 0, virtualHeight(), true, smear ? 255 : 255 - blur_amount, blur_amount >> 1);
 }
 
 void Segment::blur2D(uint8_t blur_amount, bool smear) {
   if (!isActive() || blur_amount == 0) return; // not active
-  const unsigned cols = virtualWidth();
-  const unsigned rows = virtualHeight();
+  const int cols = virtualWidth();
+  const int rows = virtualHeight();
 
   const uint8_t keep = smear ? 255 : 255 - blur_amount;
   const uint8_t seep = blur_amount >> (1 + smear);
-  uint32_t lastnew;
-  uint32_t last;
-  for (unsigned row = 0; row < rows; row++) {
-    uint32_t carryover = BLACK;
-    uint32_t curnew = BLACK;
-    for (unsigned x = 0; x < cols; x++) {
-      uint32_t cur = getPixelColorXY(x, row);
-      uint32_t part = color_fade(cur, seep);
-      curnew = color_fade(cur, keep);
-      if (x > 0) {
-        if (carryover) curnew = color_add(curnew, carryover, true);
-        uint32_t prev = color_add(lastnew, part, true);
-        // optimization: only set pixel if color has changed
-        if (last != prev) setPixelColorXY(x - 1, row, prev);
-      } else setPixelColorXY(x, row, curnew); // first pixel
-      lastnew = curnew;
-      last = cur; // save original value for comparison on next iteration
-      carryover = part;
-    }
-    setPixelColorXY(cols-1, row, curnew); // set last pixel
-  }
-  for (unsigned col = 0; col < cols; col++) {
-    uint32_t carryover = BLACK;
-    uint32_t curnew = BLACK;
-    for (unsigned y = 0; y < rows; y++) {
-      uint32_t cur = getPixelColorXY(col, y);
-      uint32_t part = color_fade(cur, seep);
-      curnew = color_fade(cur, keep);
-      if (y > 0) {
-        if (carryover) curnew = color_add(curnew, carryover, true);
-        uint32_t prev = color_add(lastnew, part, true);      
-        // optimization: only set pixel if color has changed
-        if (last != prev) setPixelColorXY(col, y - 1, prev);
-      } else setPixelColorXY(col, y, curnew); // first pixel
-      lastnew = curnew;
-      last = cur; //save original value for comparison on next iteration
-      carryover = part;        
-    }
-    setPixelColorXY(col, rows - 1, curnew);
-  }
+  for (int row = 0; row < rows; row++) blurLine(0, row, cols, false, keep, seep);
+  for (int col = 0; col < cols; col++) blurLine(col, 0, rows, true, keep, seep);
 }
 
 // 2D Box blur
@@ -454,16 +329,18 @@ void Segment::moveX(int8_t delta, bool wrap) {
   const int cols = virtualWidth();
   const int rows = virtualHeight();
   if (!delta || abs(delta) >= cols) return;
+  uint32_t oldPxCol[cols];
   uint32_t newPxCol[cols];
   for (int y = 0; y < rows; y++) {
+    getPixelSpan(0, y, oldPxCol, cols);
     if (delta > 0) {
-      for (int x = 0; x < cols-delta; x++)    newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = cols-delta; x < cols; x++) newPxCol[x] = getPixelColorXY(wrap ? (x + delta) - cols : x, y);
+      for (int x = 0; x < cols-delta; x++)    newPxCol[x] = oldPxCol[x + delta];
+      for (int x = cols-delta; x < cols; x++) newPxCol[x] = oldPxCol[wrap ? (x + delta) - cols : x];
     } else {
-      for (int x = cols-1; x >= -delta; x--) newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = -delta-1; x >= 0; x--)    newPxCol[x] = getPixelColorXY(wrap ? (x + delta) + cols : x, y);
+      for (int x = cols-1; x >= -delta; x--) newPxCol[x] = oldPxCol[x + delta];
+      for (int x = -delta-1; x >= 0; x--)    newPxCol[x] = oldPxCol[wrap ? (x + delta) + cols : x];
     }
-    for (int x = 0; x < cols; x++) setPixelColorXY(x, y, newPxCol[x]);
+    setPixelSpan(0, y, newPxCol, cols);
   }
 }
 
@@ -472,16 +349,18 @@ void Segment::moveY(int8_t delta, bool wrap) {
   const int cols = virtualWidth();
   const int rows = virtualHeight();
   if (!delta || abs(delta) >= rows) return;
+  uint32_t oldPxCol[rows];
   uint32_t newPxCol[rows];
   for (int x = 0; x < cols; x++) {
+    getPixelSpan(x, 0, oldPxCol, rows, true);
     if (delta > 0) {
-      for (int y = 0; y < rows-delta; y++)    newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = rows-delta; y < rows; y++) newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) - rows : y);
+      for (int y = 0; y < rows-delta; y++)    newPxCol[y] = oldPxCol[y + delta];
+      for (int y = rows-delta; y < rows; y++) newPxCol[y] = oldPxCol[wrap ? (y + delta) - rows : y];
     } else {
-      for (int y = rows-1; y >= -delta; y--) newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = -delta-1; y >= 0; y--)    newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) + rows : y);
+      for (int y = rows-1; y >= -delta; y--) newPxCol[y] = oldPxCol[y + delta];
+      for (int y = -delta-1; y >= 0; y--)    newPxCol[y] = oldPxCol[wrap ? (y + delta) + rows : y];
     }
-    for (int y = 0; y < rows; y++) setPixelColorXY(x, y, newPxCol[y]);
+    setPixelSpan(x, 0, newPxCol, rows, true);
   }
 }
 
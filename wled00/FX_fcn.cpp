@@ -66,7 +66,43 @@ static constexpr bool validatePinsAndTypes(const unsigned* types, unsigned numTy
 ///////////////////////////////////////////////////////////////////////////////
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
+
+// Segments are copied, changed and deleted from the async web server task as well as from loop(). On ESP32 every
+// access to the effect data arena, and every copy of effect data that compactData() could move, holds arenaMutex.
+// On ESP8266 async callbacks do not preempt loop() and no locking is needed.
+#ifdef ARDUINO_ARCH_ESP32
+static SemaphoreHandle_t arenaMutex = xSemaphoreCreateRecursiveMutex();
+struct ArenaLock {
+  ArenaLock()  { xSemaphoreTakeRecursive(arenaMutex, portMAX_DELAY); }
+  ~ArenaLock() { xSemaphoreGiveRecursive(arenaMutex); }
+};
+#else
+struct ArenaLock {
+  ArenaLock() {}
+};
+#endif
+
+// pixels set through JSON API are staged by the async web server task and applied by WS2812FX::service();
+// on ESP32 staging, applying and (re)allocating a pixel buffer hold pixelsMutex
+#ifdef ARDUINO_ARCH_ESP32
+static SemaphoreHandle_t pixelsMutex = xSemaphoreCreateRecursiveMutex();
+struct PixelsLock {
+  PixelsLock()  { xSemaphoreTakeRecursive(pixelsMutex, portMAX_DELAY); }
+  ~PixelsLock() { xSemaphoreGiveRecursive(pixelsMutex); }
+};
+#else
+struct PixelsLock {
+  PixelsLock() {}
+};
+#endif
+
 uint16_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
+uint8_t *Segment::_dataArena = nullptr;
+uint8_t  Segment::_arenaBlocks = 0;
+uint16_t Segment::_arenaCompactions = 0;
+bool     Segment::_arenaFragmented = false;
+Segment::Transition *Segment::_transitionPool = nullptr;
+uint8_t  Segment::_transitionsUsed[(MAX_NUM_SEGMENTS+7)/8] = {0};
 uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
@@ -75,6 +111,15 @@ CRGBPalette16 Segment::_randomPalette     = generateRandomPalette();  // was CRG
 CRGBPalette16 Segment::_newRandomPalette  = generateRandomPalette();  // was CRGBPalette16(DEFAULT_COLOR);
 uint16_t      Segment::_lastPaletteChange = 0; // perhaps it should be per segment
 uint16_t      Segment::_lastPaletteBlend  = 0; //in millis (lowest 16 bits only)
+Segment::palcache_t Segment::_paletteCache[PALETTE_CACHE_SIZE];
+uint16_t      Segment::_paletteCacheTick  = 0;
+#ifdef WLED_PALETTE_LUT
+CRGB          Segment::_paletteLUT[256];
+CRGBPalette16 Segment::_paletteLUTSrc     = CRGBPalette16(CRGB::Black);
+uint8_t       Segment::_paletteLUTHits    = 0;
+bool          Segment::_paletteLUTValid   = false;
+bool          Segment::_paletteLUTNoBlend = false;
+#endif
 
 #ifndef WLED_DISABLE_MODE_BLEND
 bool Segment::_modeBlend = false;
@@ -88,8 +133,22 @@ Segment::Segment(const Segment &orig) {
   name = nullptr;
   data = nullptr;
   _dataLen = 0;
+  pixels = nullptr;
+  _pixelsLen = 0;
+  _pixelsStaged = nullptr; // staged pixels belong to original segment
+  _pixelsStagedLen = 0;
+  _map = nullptr; // index table is rebuilt in WS2812FX::service()
+  _mapLen = 0;
+  memset(_mapKey, 0, sizeof(_mapKey)); // never matches an active segment
+  _m12Map = nullptr; // expansion table is rebuilt in WS2812FX::service()
+  _m12Len = _m12Rays = 0;
+  _m12Key = 0;
   if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
-  if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
+  if (orig.data) {
+    ArenaLock lock; // orig.data must not be moved by compactData() while copying
+    if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen);
+  }
+  if (orig.pixels) copyPixels(orig);
 }
 
 // move constructor
@@ -100,6 +159,14 @@ Segment::Segment(Segment &&orig) noexcept {
   orig.name = nullptr;
   orig.data = nullptr;
   orig._dataLen = 0;
+  orig.pixels = nullptr;
+  orig._pixelsLen = 0;
+  orig._pixelsStaged = nullptr;
+  orig._pixelsStagedLen = 0;
+  orig._map = nullptr;
+  orig._mapLen = 0;
+  orig._m12Map = nullptr;
+  orig._m12Len = orig._m12Rays = 0;
 }
 
 // copy assignment
@@ -110,14 +177,32 @@ Segment& Segment::operator= (const Segment &orig) {
     if (name) { delete[] name; name = nullptr; }
     stopTransition();
     deallocateData();
+    deallocatePixels();
+    discardStagedPixels();
+    deallocateMap();
+    deallocateMap1D2D();
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
+    pixels = nullptr;
+    _pixelsLen = 0;
+    _pixelsStaged = nullptr;
+    _pixelsStagedLen = 0;
+    _map = nullptr; // index table is rebuilt in WS2812FX::service()
+    _mapLen = 0;
+    memset(_mapKey, 0, sizeof(_mapKey)); // never matches an active segment
+    _m12Map = nullptr; // expansion table is rebuilt in WS2812FX::service()
+    _m12Len = _m12Rays = 0;
+    _m12Key = 0;
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
-    if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
+    if (orig.data) {
+      ArenaLock lock; // orig.data must not be moved by compactData() while copying
+      if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen);
+    }
+    if (orig.pixels) copyPixels(orig);
   }
   return *this;
 }
@@ -129,16 +214,186 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (name) { delete[] name; name = nullptr; } // free old name
     stopTransition();
     deallocateData(); // free old runtime data
+    deallocatePixels(); // free old pixel buffer
+    discardStagedPixels(); // free old staged pixels
+    deallocateMap();    // free old index table
+    deallocateMap1D2D(); // free old expansion table
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
+    orig.pixels = nullptr;
+    orig._pixelsLen = 0;
+    orig._pixelsStaged = nullptr;
+    orig._pixelsStagedLen = 0;
+    orig._map = nullptr;
+    orig._mapLen = 0;
+    orig._m12Map = nullptr;
+    orig._m12Len = orig._m12Rays = 0;
     orig._t   = nullptr; // old segment cannot be in transition
   }
   return *this;
 }
 
-// allocates effect data buffer on heap and initialises (erases) it
+// Effect data arena: a single heap block that is split into 4 byte aligned blocks, each preceded by a header.
+// Free neighbours are merged while searching for a fit. If an allocation fails only because free space is
+// fragmented, blocks are moved together at the start of next WS2812FX::service() (see compactData()).
+typedef struct ArenaBlock {
+  uint16_t size; // size of block (excluding header)
+  uint16_t used;
+} arenablk_t;
+constexpr size_t Arena_Size = (DATA_ARENA_SIZE + 3) & ~3;
+static_assert(Arena_Size <= UINT16_MAX, "DATA_ARENA_SIZE too large");
+
+static inline arenablk_t *nextArenaBlock(arenablk_t *b) { return (arenablk_t*)((uint8_t*)(b+1) + b->size); }
+
+void *Segment::allocateArena(size_t len) {
+  if (len == 0 || len > Arena_Size - sizeof(arenablk_t)) return nullptr;
+  ArenaLock lock;
+  if (!_dataArena) {
+    // arena is kept once allocated (releasing it would fragment heap again), except when unused on ESP8266 (see compactData())
+    if (ESP.getFreeHeap() < MIN_HEAP_SIZE + Arena_Size) return nullptr;
+    // do not use SPI RAM on ESP32 since it is slow
+    _dataArena = (uint8_t*)malloc(Arena_Size);
+    if (!_dataArena) return nullptr;
+    arenablk_t *b = (arenablk_t*)_dataArena;
+    b->size = Arena_Size - sizeof(arenablk_t);
+    b->used = false;
+    DEBUG_PRINTF_P(PSTR("Effect data arena: %uB\n"), Arena_Size);
+  }
+  len = (len + 3) & ~3;
+  const uint8_t *end = _dataArena + Arena_Size;
+  unsigned avail = 0;
+  for (arenablk_t *b = (arenablk_t*)_dataArena; (uint8_t*)b < end; b = nextArenaBlock(b)) {
+    if (b->used) continue;
+    // merge with following free blocks
+    for (arenablk_t *n = nextArenaBlock(b); (uint8_t*)n < end && !n->used; n = nextArenaBlock(b)) b->size += sizeof(arenablk_t) + n->size;
+    avail += b->size;
+    if (b->size < len) continue;
+    if (b->size >= len + sizeof(arenablk_t) + 4) {
+      // split, remainder stays free
+      arenablk_t *r = (arenablk_t*)((uint8_t*)(b+1) + len);
+      r->size = b->size - len - sizeof(arenablk_t);
+      r->used = false;
+      b->size = len;
+    }
+    b->used = true;
+    _arenaBlocks++;
+    return b+1;
+  }
+  if (avail >= len) _arenaFragmented = true; // enough space but no single block large enough
+  return nullptr;
+}
+
+bool Segment::inArena(const void *p) {
+  return _dataArena && (const uint8_t*)p >= _dataArena && (const uint8_t*)p < _dataArena + Arena_Size;
+}
+
+void Segment::freeArena(void *p) {
+  ArenaLock lock;
+  if (!inArena(p)) return;
+  ((arenablk_t*)p - 1)->used = false; // merged with neighbours on next allocation
+  _arenaBlocks--;
+}
+
+// updates all references to effect data block (segment data and copies held by transitions)
+bool Segment::relocateData(byte *from, byte *to) {
+  bool found = false;
+  for (segment &seg : strip._segments) {
+    if (seg.data == from) { seg.data = to; found = true; }
+    #ifndef WLED_DISABLE_MODE_BLEND
+    if (seg._t && seg._t->_segT._dataT == from) { seg._t->_segT._dataT = to; found = true; }
+    #endif
+  }
+  return found;
+}
+
+// moves all used arena blocks to the start of arena so that free space forms a single block
+// effects only hold on to SEGENV.data within a single call so blocks can be moved in between frames
+// on ESP8266 an unused arena is released instead, RAM is too scarce to hold it for effects that may never need it
+// must only be called from loop() when no effect is running (i.e. at the start of WS2812FX::service())
+void Segment::compactData() {
+  if (!_dataArena) return;
+  #ifdef ESP8266
+  if (_arenaBlocks == 0) {
+    free(_dataArena);
+    _dataArena = nullptr;
+    _arenaFragmented = false;
+    DEBUG_PRINTLN(F("Effect data arena released."));
+    return;
+  }
+  #endif
+  if (!_arenaFragmented) return;
+  ArenaLock lock;
+  _arenaFragmented = false;
+  const uint8_t *end = _dataArena + Arena_Size;
+  // blocks held by temporary segment copies (outside of strip) can not be updated, do not move anything then
+  for (arenablk_t *b = (arenablk_t*)_dataArena; (uint8_t*)b < end; b = nextArenaBlock(b)) {
+    if (b->used && !relocateData((byte*)(b+1), (byte*)(b+1))) return;
+  }
+  uint8_t *dst = _dataArena;
+  for (arenablk_t *b = (arenablk_t*)_dataArena; (uint8_t*)b < end; ) {
+    arenablk_t *n = nextArenaBlock(b); // moving a block down never overwrites the next header
+    if (b->used) {
+      size_t len = sizeof(arenablk_t) + b->size;
+      if ((uint8_t*)b != dst) {
+        memmove(dst, b, len);
+        relocateData((byte*)(b+1), dst + sizeof(arenablk_t));
+      }
+      dst += len;
+    }
+    b = n;
+  }
+  if (dst < end) {
+    arenablk_t *b = (arenablk_t*)dst;
+    b->size = end - dst - sizeof(arenablk_t);
+    b->used = false;
+  }
+  _arenaCompactions++;
+  DEBUG_PRINTF_P(PSTR("Effect data arena compacted (%u).\n"), _arenaCompactions);
+}
+
+void Segment::getArenaInfo(arenainfo_t &info) {
+  info = {0, 0, 0, _arenaCompactions};
+  ArenaLock lock;
+  if (!_dataArena) return;
+  info.size = Arena_Size;
+  const uint8_t *end = _dataArena + Arena_Size;
+  unsigned run = 0; // free neighbours are not merged yet
+  for (arenablk_t *b = (arenablk_t*)_dataArena; (uint8_t*)b < end; b = nextArenaBlock(b)) {
+    if (b->used) {
+      info.used += sizeof(arenablk_t) + b->size;
+      run = 0;
+    } else {
+      run += (run ? sizeof(arenablk_t) : 0) + b->size;
+      if (run > info.largest) info.largest = run;
+    }
+  }
+}
+
+// transitions are taken from a pool allocated once (one per segment) instead of new/delete on every change
+Segment::Transition *Segment::newTransition(uint16_t dur) {
+  if (!_transitionPool && ESP.getFreeHeap() > MIN_HEAP_SIZE + MAX_NUM_SEGMENTS * sizeof(Transition)) {
+    _transitionPool = (Transition*)malloc(MAX_NUM_SEGMENTS * sizeof(Transition));
+  }
+  if (_transitionPool) for (size_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    if (_transitionsUsed[i/8] & (1 << (i%8))) continue;
+    _transitionsUsed[i/8] |= 1 << (i%8);
+    _transitionPool[i] = Transition(dur);
+    return &_transitionPool[i];
+  }
+  return new Transition(dur); // pool not available or exhausted
+}
+
+void Segment::deleteTransition(Transition *t) {
+  if (_transitionPool && t >= _transitionPool && t < _transitionPool + MAX_NUM_SEGMENTS) {
+    size_t i = t - _transitionPool;
+    _transitionsUsed[i/8] &= ~(1 << (i%8));
+  } else
+    delete t;
+}
+
+// allocates effect data buffer (in effect data arena or on heap) and initialises (erases) it
 bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
   if (len == 0) return false; // nothing to do
   if (data && _dataLen >= len) {          // already allocated enough (reduce fragmentation)
@@ -146,6 +401,7 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
     return true;
   }
   //DEBUG_PRINTF_P(PSTR("--   Allocating data (%d): %p\n", len, this);
+  ArenaLock lock;
   deallocateData(); // if the old buffer was smaller release it first
   if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
     // not enough memory
@@ -154,8 +410,10 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
     errorFlag = ERR_NORAM;
     return false;
   }
-  // do not use SPI RAM on ESP32 since it is slow
-  data = (byte*)calloc(len, sizeof(byte));
+  data = (byte*)allocateArena(len);
+  if (data) memset(data, 0, len);
+  // arena full or fragmented (will be compacted in next frame), do not use SPI RAM on ESP32 since it is slow
+  else data = (byte*)calloc(len, sizeof(byte));
   if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } // allocation failed
   Segment::addUsedSegmentData(len);
   //DEBUG_PRINTF_P(PSTR("---  Allocated data (%p): %d/%d -> %p\n"), this, len, Segment::getUsedSegmentData(), data);
@@ -164,10 +422,12 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
 }
 
 void IRAM_ATTR_YN Segment::deallocateData() {
+  ArenaLock lock; // data must not be moved by compactData() while it is released
   if (!data) { _dataLen = 0; return; }
   //DEBUG_PRINTF_P(PSTR("---  Released data (%p): %d/%d -> %p\n"), this, _dataLen, Segment::getUsedSegmentData(), data);
   if ((Segment::getUsedSegmentData() > 0) && (_dataLen > 0)) { // check that we don't have a dangling / inconsistent data pointer
-    free(data);
+    if (inArena(data)) freeArena(data);
+    else               free(data);
   } else {
     DEBUG_PRINTF_P(PSTR("---- Released data (%p): inconsistent UsedSegmentData (%d/%d), cowardly refusing to free nothing.\n"), this, _dataLen, Segment::getUsedSegmentData());
   }
@@ -176,6 +436,248 @@ void IRAM_ATTR_YN Segment::deallocateData() {
   _dataLen = 0;
 }
 
+// allocates pixel buffer matching current virtual segment dimensions (2D and matrix segments use virtualWidth()*virtualHeight())
+// if there is not enough RAM the segment draws directly onto the strip (see setPixelColorDirect())
+// must only be called from loop() (i.e. WS2812FX::service()) or while strip is suspended
+bool Segment::allocatePixels() {
+  if (!isActive()) { PixelsLock lock; deallocatePixels(); return false; }
+  unsigned len = bufferLength();
+  if (pixels && _pixelsLen == len) return true; // already allocated
+  PixelsLock lock; // newStagedPixels() may be reading old buffer
+  deallocatePixels(); // geometry changed, old content is useless
+  #ifndef WLED_DISABLE_MODE_BLEND
+  if (_t && _t->_pixelsT) { free(_t->_pixelsT); _t->_pixelsT = nullptr; } // same for previous effect
+  #endif
+  // do not use SPI RAM on ESP32 since it is slow
+  pixels = (uint32_t*)calloc(len, sizeof(uint32_t));
+  if (!pixels) {
+    DEBUG_PRINTF_P(PSTR("!!! Pixel buffer allocation failed (%u) !!!\n"), len);
+    errorFlag = ERR_NORAM;
+    return false;
+  }
+  _pixelsLen = len;
+  return true;
+}
+
+void Segment::deallocatePixels() {
+  if (pixels) free(pixels);
+  pixels = nullptr;
+  _pixelsLen = 0;
+}
+
+unsigned Segment::bufferLength() const {
+  return inMatrix() ? virtualWidth() * virtualHeight() : virtualLength();
+}
+
+// pixels are staged in a separate buffer since WS2812FX::service() may be (re)allocating or rendering into pixels[]
+// while JSON API runs on the async web server task; staged pixels not applied yet are kept too
+uint32_t *Segment::newStagedPixels(bool keep) const {
+  const unsigned len = bufferLength();
+  uint32_t *px = (uint32_t*)calloc(len, sizeof(uint32_t));
+  if (!px) {
+    errorFlag = ERR_NORAM;
+    return nullptr;
+  }
+  if (keep) {
+    PixelsLock lock;
+    if      (_pixelsStaged && _pixelsStagedLen == len) memcpy(px, _pixelsStaged, len * sizeof(uint32_t));
+    else if (pixels && _pixelsLen == len)              memcpy(px, pixels, len * sizeof(uint32_t));
+  }
+  return px;
+}
+
+// takes ownership of px (replaces pixels staged before)
+void Segment::stagePixels(uint32_t *px, unsigned len) {
+  PixelsLock lock;
+  discardStagedPixels();
+  _pixelsStaged = px;
+  _pixelsStagedLen = len;
+}
+
+void Segment::applyStagedPixels() {
+  if (!_pixelsStaged) return;
+  PixelsLock lock;
+  if (pixels && _pixelsLen == _pixelsStagedLen) memcpy(pixels, _pixelsStaged, _pixelsLen * sizeof(uint32_t)); // dropped if geometry changed again
+  discardStagedPixels();
+}
+
+void Segment::discardStagedPixels() {
+  if (_pixelsStaged) free(_pixelsStaged);
+  _pixelsStaged = nullptr;
+  _pixelsStagedLen = 0;
+}
+
+// duplicates pixel buffer of another segment (used by copy constructor & assignment)
+void Segment::copyPixels(const Segment &orig) {
+  pixels = (uint32_t*)malloc(orig._pixelsLen * sizeof(uint32_t));
+  if (!pixels) return; // will be re-allocated in WS2812FX::service()
+  memcpy(pixels, orig.pixels, orig._pixelsLen * sizeof(uint32_t));
+  _pixelsLen = orig._pixelsLen;
+}
+
+// expands virtual pixel (x,y) of a segment onto physical pixels (taking into account start, grouping, spacing,
+// reverse, mirror, transpose [and offset]) and calls f(i) for each of them; 1D segments use x only
+// i is the logical strip index (ledmap not applied)
+template<typename F> static void expandPixel(const Segment &seg, int x, int y, F f) {
+  const int groupLen = seg.groupLength();
+  const int W = seg.width();
+  const int H = seg.height();
+
+#ifndef WLED_DISABLE_2D
+  if (seg.inMatrix()) {
+    const int vW = seg.virtualWidth();
+    const int vH = seg.virtualHeight();
+    auto XY = [&](int x, int y) { return unsigned((seg.startY + y) * Segment::maxWidth + seg.start + x); };
+    int px = seg.reverse   ? vW - x - 1 : x;
+    int py = seg.reverse_y ? vH - y - 1 : y;
+    if (seg.transpose) std::swap(px, py); // swap X & Y if segment transposed
+    px *= groupLen; // expand to physical pixels
+    py *= groupLen; // expand to physical pixels
+    if (px >= W || py >= H) return; // pixel would fall out of segment
+    for (int j = 0; j < seg.grouping && py + j < H; j++) {   // groupping vertically
+      for (int g = 0; g < seg.grouping && px + g < W; g++) { // groupping horizontally
+        int xX = px + g, yY = py + j;
+        f(XY(xX, yY));
+        if (seg.mirror) { //set the corresponding horizontally mirrored pixel
+          if (seg.transpose) f(XY(xX, H - yY - 1));
+          else               f(XY(W - xX - 1, yY));
+        }
+        if (seg.mirror_y) { //set the corresponding vertically mirrored pixel
+          if (seg.transpose) f(XY(W - xX - 1, yY));
+          else               f(XY(xX, H - yY - 1));
+        }
+        if (seg.mirror_y && seg.mirror) { //set the corresponding vertically AND horizontally mirrored pixel
+          f(XY(W - xX - 1, H - yY - 1));
+        }
+      }
+    }
+    return;
+  }
+#endif
+
+  // 1D segment: expand pixel (taking into account start, grouping, spacing [and offset])
+  const int len = seg.length();
+  int i = x * groupLen;
+  if (seg.reverse) { // is segment reversed?
+    if (seg.mirror) i = (len - 1) / 2 - i; // is segment mirrored? only need to index half the pixels
+    else            i = (len - 1) - i;
+  }
+  i += seg.start; // starting pixel in a group
+  // set all the pixels in the group
+  for (int j = 0; j < seg.grouping; j++) {
+    unsigned indexSet = i + (seg.reverse ? -j : j);
+    if (indexSet >= seg.start && indexSet < seg.stop) {
+      if (seg.mirror) { //set the corresponding mirrored pixel
+        unsigned indexMir = seg.stop - indexSet + seg.start - 1;
+        indexMir += seg.offset; // offset/phase
+        if (indexMir >= seg.stop) indexMir -= len; // wrap
+        f(indexMir);
+      }
+      indexSet += seg.offset; // offset/phase
+      if (indexSet >= seg.stop) indexSet -= len; // wrap
+      f(indexSet);
+    }
+  }
+}
+
+// walks through all physical pixels of a segment in drawing order and calls f(v, i) for each of them
+// v is the index into segment's pixel buffer and i is the logical strip index (ledmap not applied)
+template<typename F> static void expandSegment(const Segment &seg, F f) {
+#ifndef WLED_DISABLE_2D
+  if (seg.inMatrix()) {
+    const int vW = seg.virtualWidth();
+    const int vH = seg.virtualHeight();
+    for (int y = 0; y < vH; y++) for (int x = 0; x < vW; x++) {
+      const unsigned v = x + y * vW;
+      expandPixel(seg, x, y, [&](unsigned i) { f(v, i); });
+    }
+    return;
+  }
+#endif
+  const int vLen = seg.virtualLength(); // 1D segment
+  for (int v = 0; v < vLen; v++) expandPixel(seg, v, 0, [&](unsigned i) { f(v, i); });
+}
+
+// segments without pixel buffer (not enough RAM) draw directly onto the strip, like before buffering was introduced
+// v is the pixel buffer index the pixel would have (x + y * virtualWidth() in matrix)
+void Segment::setPixelColorDirect(unsigned v, uint32_t col) const {
+  const unsigned vW = inMatrix() ? virtualWidth() : UINT16_MAX;
+  const uint8_t bri = currentBri();
+  if (bri < 255) col = color_fade(col, bri);
+  expandPixel(*this, v % vW, v / vW, [&](unsigned i) {
+#ifndef WLED_DISABLE_MODE_BLEND
+    if (_modeBlend) { strip.setPixelColor(i, color_blend(strip.getPixelColor(i), col, 0xFFFFU - progress(), true)); return; }
+#endif
+    strip.setPixelColor(i, col);
+  });
+}
+
+// returns (lossy) color of the first physical pixel of virtual pixel v from the strip
+uint32_t Segment::getPixelColorDirect(unsigned v) const {
+  const unsigned vW = inMatrix() ? virtualWidth() : UINT16_MAX;
+  int first = -1;
+  expandPixel(*this, v % vW, v / vW, [&](unsigned i) { if (first < 0) first = i; });
+  return first < 0 ? 0 : strip.getPixelColor(first);
+}
+
+// packs everything (besides ledmap) that affects the index table
+void Segment::getMapKey(uint32_t *key) const {
+  constexpr uint16_t mapOptions = 0x01CA; // reverse, mirror, reverse_y, mirror_y, transpose
+  key[0] = start  | (uint32_t(stop) << 16);
+  key[1] = offset | (uint32_t(startY) << 16) | (uint32_t(stopY) << 24);
+  key[2] = grouping | (uint32_t(spacing) << 8) | (uint32_t(options & mapOptions) << 16);
+}
+
+// (re)builds table of physical strip indices (ledmap applied) for every virtual pixel, used by WS2812FX::blendSegment()
+// table is rebuilt only if segment geometry, options or ledmap changed; if there is not enough memory
+// segment is expanded on the fly (table is an optional speedup)
+// must only be called from loop() (i.e. WS2812FX::service()) or while strip is suspended, after allocatePixels()
+bool Segment::updateMap() {
+  if (!isActive() || !pixels) { deallocateMap(); return false; }
+  uint32_t key[3];
+  getMapKey(key);
+  const uint8_t gen = strip.getMapGeneration();
+  if (_mapGen == gen && memcmp(key, _mapKey, sizeof(_mapKey)) == 0) return _map != nullptr; // nothing changed (do not retry failed allocation)
+  deallocateMap();
+  memcpy(_mapKey, key, sizeof(_mapKey));
+  _mapGen = gen;
+  const unsigned length = strip.getLength();
+  // ledmap is always applied (WS2812FX::blendSegment() does not use table while realtime ignores ledmap)
+  auto mapped = [](unsigned i) { return i < strip.customMappingSize ? strip.customMappingTable[i] : i; };
+  // count physical pixels first
+  unsigned len = 0;
+  expandSegment(*this, [&](unsigned v, unsigned i) { if (v < _pixelsLen && mapped(i) < length) len++; });
+  if (len == 0 || len > UINT16_MAX) return false;
+  if (ESP.getFreeHeap() < MIN_HEAP_SIZE + len * sizeof(pxmap_t)) return false; // not enough memory, expand on the fly
+  // do not use SPI RAM on ESP32 since it is slow
+  _map = (pxmap_t*)malloc(len * sizeof(pxmap_t));
+  if (!_map) return false;
+  _mapFirst = UINT16_MAX;
+  _mapLast  = 0;
+  expandSegment(*this, [&](unsigned v, unsigned i) {
+    unsigned p = mapped(i);
+    if (v < _pixelsLen && p < length && _mapLen < len) {
+      _map[_mapLen++] = {uint16_t(v), uint16_t(p)};
+      if (p < _mapFirst) _mapFirst = p;
+      if (p > _mapLast)  _mapLast  = p;
+    }
+  });
+  return true;
+}
+
+void Segment::deallocateMap() {
+  if (_map) free(_map);
+  _map = nullptr;
+  _mapLen = 0;
+}
+
+const Segment::pxmap_t *Segment::getMap() const {
+  if (!_map || _mapGen != strip.getMapGeneration()) return nullptr;
+  uint32_t key[3];
+  getMapKey(key);
+  return memcmp(key, _mapKey, sizeof(_mapKey)) ? nullptr : _map;
+}
+
 /**
   * If reset of this segment was requested, clears runtime
   * settings of this segment.
@@ -208,6 +710,34 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
     case FX_MODE_RAILWAY    : pal =  3; break; // prim + sec
     case FX_MODE_2DSOAP     : pal = 11; break; // rainbow colors
   }
+  // palettes that need decoding (segment colors or gradient) are kept in LRU cache keyed by palette id and colors
+  palcache_t *entry = nullptr;
+  if (pal >= 2 && pal <= 245 && (pal <= 5 || pal >= 13)) {
+    uint32_t key[3] = {0, 0, 0};
+    if (pal <= 5) {
+      // white channel is not used by palettes; palette 5 looks different if tertiary color is off (marked with 0xFF000000)
+      key[0] = gamma32(colors[0]) & 0x00FFFFFF;
+      if (pal > 2) key[1] = gamma32(colors[1]) & 0x00FFFFFF;
+      if (pal > 3) key[2] = (pal == 5 && !colors[2]) ? 0xFF000000 : gamma32(colors[2]) & 0x00FFFFFF;
+    }
+    unsigned oldest = 0;
+    for (unsigned i = 0; i < PALETTE_CACHE_SIZE; i++) {
+      palcache_t &e = _paletteCache[i];
+      if (e.id == pal && e.key[0] == key[0] && e.key[1] == key[1] && e.key[2] == key[2]) {
+        e.lastUsed = ++_paletteCacheTick;
+        targetPalette = e.palette;
+        return targetPalette;
+      }
+      // free entries (id 0) are never hit and are taken first
+      if (e.id == 0 || (_paletteCache[oldest].id != 0 && uint16_t(_paletteCacheTick - e.lastUsed) > uint16_t(_paletteCacheTick - _paletteCache[oldest].lastUsed))) oldest = i;
+    }
+    entry = &_paletteCache[oldest];
+    entry->id = pal;
+    entry->key[0] = key[0];
+    entry->key[1] = key[1];
+    entry->key[2] = key[2];
+    entry->lastUsed = ++_paletteCacheTick;
+  }
   switch (pal) {
     case 0: //default palette. Exceptions for specific effects above
       targetPalette = PartyColors_p; break;
@@ -260,6 +790,7 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
       }
       break;
   }
+  if (entry) entry->palette = targetPalette;
   return targetPalette;
 }
 
@@ -271,7 +802,7 @@ void Segment::startTransition(uint16_t dur) {
   if (isInTransition()) return; // already in transition no need to store anything
 
   // starting a transition has to occur before change so we get current values 1st
-  _t = new Transition(dur); // no previous transition running
+  _t = newTransition(dur); // no previous transition running
   if (!_t) return; // failed to allocate data
 
   //DEBUG_PRINTF_P(PSTR("-- Started transition: %p (%p)\n"), this, _t);
@@ -280,12 +811,14 @@ void Segment::startTransition(uint16_t dur) {
   _t->_cctT           = cct;
 #ifndef WLED_DISABLE_MODE_BLEND
   if (modeBlending) {
+    ArenaLock lock; // data must not be moved by compactData() while copying
     swapSegenv(_t->_segT);
     _t->_modeT          = mode;
     _t->_segT._dataLenT = 0;
     _t->_segT._dataT    = nullptr;
     if (_dataLen > 0 && data) {
-      _t->_segT._dataT = (byte *)malloc(_dataLen);
+      _t->_segT._dataT = (byte *)allocateArena(_dataLen);
+      if (!_t->_segT._dataT) _t->_segT._dataT = (byte *)malloc(_dataLen);
       if (_t->_segT._dataT) {
         //DEBUG_PRINTF_P(PSTR("--  Allocated duplicate data (%d) for %p: %p\n"), _dataLen, this, _t->_segT._dataT);
         memcpy(_t->_segT._dataT, data, _dataLen);
@@ -304,20 +837,25 @@ void Segment::stopTransition() {
   if (isInTransition()) {
     //DEBUG_PRINTF_P(PSTR("-- Stopping transition: %p\n"), this);
     #ifndef WLED_DISABLE_MODE_BLEND
+    ArenaLock lock;
     if (_t->_segT._dataT && _t->_segT._dataLenT > 0) {
       //DEBUG_PRINTF_P(PSTR("--  Released duplicate data (%d) for %p: %p\n"), _t->_segT._dataLenT, this, _t->_segT._dataT);
-      free(_t->_segT._dataT);
+      if (inArena(_t->_segT._dataT)) freeArena(_t->_segT._dataT);
+      else                           free(_t->_segT._dataT);
       _t->_segT._dataT = nullptr;
       _t->_segT._dataLenT = 0;
     }
+    if (_t->_pixelsT) free(_t->_pixelsT);
+    _t->_pixelsT = nullptr;
     #endif
-    delete _t;
+    deleteTransition(_t);
     _t = nullptr;
   }
 }
 
 // transition progression between 0-65535
 uint16_t IRAM_ATTR Segment::progress() const {
+  if (_frame.hasProgress) return _frame.progress; // captured at the start of the frame
   if (isInTransition()) {
     unsigned diff = millis() - _t->_start;
     if (_t->_dur > 0 && diff < _t->_dur) return diff * 0xFFFFU / _t->_dur;
@@ -394,9 +932,64 @@ void Segment::restoreSegenv(tmpsegd_t &tmpSeg) {
   data      = tmpSeg._dataT;
   _dataLen  = tmpSeg._dataLenT;
 }
+
+// previous effect continues from the last frame shown, must be called before current effect draws
+bool Segment::allocateTransitionPixels() {
+  if (!_t || !pixels) return false;
+  if (_t->_pixelsT) return true;
+  if (ESP.getFreeHeap() < MIN_HEAP_SIZE + _pixelsLen * sizeof(uint32_t)) return false; // not enough memory, draw over current effect
+  // do not use SPI RAM on ESP32 since it is slow
+  _t->_pixelsT = (uint32_t*)malloc(_pixelsLen * sizeof(uint32_t));
+  if (!_t->_pixelsT) return false;
+  memcpy(_t->_pixelsT, pixels, _pixelsLen * sizeof(uint32_t));
+  return true;
+}
+
+void Segment::swapTransitionPixels() {
+  if (!_t || !_t->_pixelsT) return;
+  uint32_t *tmp = pixels;
+  pixels = _t->_pixelsT;
+  _t->_pixelsT = tmp;
+}
+
+bool Segment::hasTransitionPixels() const {
+  return _t && _t->_pixelsT && pixels && modeBlending && currentMode() != mode;
+}
+
+// blending style kernels: compose a row of len pixels starting at (x,y) from current (nw) and previous (old) effect
+// w is the row width (segment length for 1D segments), p is transition progress (0-65535)
+typedef void (*blendspan_t)(uint32_t *dst, const uint32_t *nw, const uint32_t *old, int x, int y, int len, int w, uint16_t p);
+
+static void blendSpanFade(uint32_t *dst, const uint32_t *nw, const uint32_t *old, int x, int y, int len, int w, uint16_t p) {
+  memcpy(dst, old, len * sizeof(uint32_t));
+  blendSpan(dst, nw, len, p >> 8);
+}
+
+static void blendSpanWipe(uint32_t *dst, const uint32_t *nw, const uint32_t *old, int x, int y, int len, int w, uint16_t p) {
+  int n = constrain(int((unsigned(w) * p) >> 16) - x, 0, len); // pixels left of the edge show current effect
+  memcpy(dst, nw, n * sizeof(uint32_t));
+  memcpy(dst + n, old + n, (len - n) * sizeof(uint32_t));
+}
+
+static void blendSpanDissolve(uint32_t *dst, const uint32_t *nw, const uint32_t *old, int x, int y, int len, int w, uint16_t p) {
+  uint32_t v = x + y * w;
+  for (int i = 0; i < len; i++, v++) dst[i] = uint16_t((v * 0x9E3779B1U) >> 16) < p ? nw[i] : old[i]; // fixed pseudo random order
+}
+
+static const blendspan_t blendSpanStyles[BLEND_STYLE_COUNT] = { blendSpanFade, blendSpanWipe, blendSpanDissolve };
+
+// composes whole pixel buffer in a single pass, cost does not depend on what effects draw
+void Segment::blendTransition(uint32_t *dst) const {
+  const blendspan_t kernel = blendSpanStyles[blendingStyle < BLEND_STYLE_COUNT ? blendingStyle : BLEND_STYLE_FADE];
+  const uint16_t p = progress();
+  const int rows = is2D() ? virtualHeight() : 1;
+  const int w = _pixelsLen / rows; // 1D segment is a single row
+  for (int y = 0; y < rows; y++) kernel(dst + y*w, pixels + y*w, _t->_pixelsT + y*w, 0, y, w, w, p);
+}
 #endif
 
 uint8_t IRAM_ATTR Segment::currentBri(bool useCct) const {
+  if (_frame.hasValues) return useCct ? _frame.cct : _frame.bri;
   unsigned prog = progress();
   if (prog < 0xFFFFU) {
     unsigned curBri = (useCct ? cct : (on ? opacity : 0)) * prog;
@@ -406,16 +999,35 @@ uint8_t IRAM_ATTR Segment::currentBri(bool useCct) const {
   return (useCct ? cct : (on ? opacity : 0));
 }
 
+// captures transition progress (at time t), blended brightness, CCT and colors once per frame
+// effects and pixel setters then use the same values for the whole frame instead of calling millis() for each pixel
+void Segment::beginFrame(unsigned long t) {
+  endFrame(); // calculate fresh values
+  unsigned prog = 0xFFFFU;
+  if (isInTransition() && _t->_dur > 0) {
+    long diff = t - _t->_start;
+    if (diff < 0) prog = 0; // transition started after t was taken
+    else if ((unsigned)diff < _t->_dur) prog = diff * 0xFFFFU / _t->_dur;
+  }
+  _frame.progress    = prog;
+  _frame.hasProgress = true;
+  _frame.bri = currentBri();
+  _frame.cct = currentBri(true);
+  for (unsigned i = 0; i < NUM_COLORS; i++) _frame.colors[i] = currentColor(i);
+  _frame.hasValues = true;
+}
+
 uint8_t Segment::currentMode() const {
 #ifndef WLED_DISABLE_MODE_BLEND
   unsigned prog = progress();
-  if (modeBlending && prog < 0xFFFFU) return _t->_modeT;
+  if (modeBlending && prog < 0xFFFFU && isInTransition()) return _t->_modeT;
 #endif
   return mode;
 }
 
 uint32_t IRAM_ATTR_YN Segment::currentColor(uint8_t slot) const {
   if (slot >= NUM_COLORS) slot = 0;
+  if (_frame.hasValues) return _frame.colors[slot];
 #ifndef WLED_DISABLE_MODE_BLEND
   return isInTransition() ? color_blend(_t->_segT._colorT[slot], colors[slot], progress(), true) : colors[slot];
 #else
@@ -426,7 +1038,7 @@ uint32_t IRAM_ATTR_YN Segment::currentColor(uint8_t slot) const {
 void Segment::setCurrentPalette() {
   loadPalette(_currentPalette, palette);
   unsigned prog = progress();
-  if (strip.paletteFade && prog < 0xFFFFU) {
+  if (strip.paletteFade && prog < 0xFFFFU && isInTransition()) {
     // blend palettes
     // there are about 255 blend passes of 48 "blends" to completely blend two palettes (in _dur time)
     // minimum blend time is 100ms maximum is 65535ms
@@ -434,6 +1046,14 @@ void Segment::setCurrentPalette() {
     for (unsigned i = 0; i < noOfBlends; i++, _t->_prevPaletteBlends++) nblendPaletteTowardPalette(_t->_palT, _currentPalette, 48);
     _currentPalette = _t->_palT; // copy transitioning/temporary palette
   }
+#ifdef WLED_PALETTE_LUT
+  // lookup table stays valid as long as consecutive segments use the same palette
+  if (_paletteLUTSrc != _currentPalette) {
+    _paletteLUTSrc   = _currentPalette;
+    _paletteLUTValid = false;
+    _paletteLUTHits  = 0;
+  }
+#endif
 }
 
 // relies on WS2812FX::service() to call it for each frame
@@ -468,7 +1088,10 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
 
   stateChanged = true; // send UDP/WS broadcast
 
-  if (stop) fill(BLACK); // turn old segment range off (clears pixels if changing spacing)
+  if (stop) { // turn old segment range off (clears pixels if changing spacing)
+    fill(BLACK);
+    strip.blendSegment(*this);
+  }
   if (grp) { // prevent assignment of 0
     grouping = grp;
     spacing = spc;
@@ -641,6 +1264,8 @@ static float getPinwheelAngle(int i, int vW, int vH) {
   // else
   return float(i) * Int_to_Rad_XL;
 }
+// Pinwheel helper function: number of steps odd rays skip when drawn next to previous ray
+static inline int pinwheelJump(int vW, int vH) { return min(vW/3, vH/3); }
 // Pinwheel helper function: matrix dimensions to number of rays
 static int getPinwheelLength(int vW, int vH) {
   int maxXY = max(vW, vH);
@@ -650,6 +1275,171 @@ static int getPinwheelLength(int vW, int vH) {
   // else
   return Pinwheel_Steps_XL;
 }
+
+// Arc helper function: calls f(x, y) for every 2D pixel of 1D pixel i (x & y may fall outside of segment)
+template<typename F> static void expandArc(int i, F f) {
+  if (i == 0) { f(0, 0); return; }
+  float r = i;
+  float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
+  for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
+    int x = roundf(sin_t(rad) * r);
+    int y = roundf(cos_t(rad) * r);
+    // exploit symmetry
+    f(x, y);
+    f(y, x);
+  }
+  // Bresenham’s Algorithm (may not fill every pixel)
+  //int d = 3 - (2*i);
+  //int y = i, x = 0;
+  //while (y >= x) {
+  //  f(x, y);
+  //  f(y, x);
+  //  x++;
+  //  if (d > 0) {
+  //    y--;
+  //    d += 4 * (x - y) + 10;
+  //  } else {
+  //    d += 4 * x + 6;
+  //  }
+  //}
+}
+
+// Pinwheel helper function: draws ray i (i = angle --> 0 - 296  (Big), 0 - 192  (Medium), 0 - 72 (Small))
+// calls f(x, y, step) for every distinct pixel of the ray; jump starts ray further from center
+template<typename F> static void expandPinwheel(int i, int vW, int vH, bool jump, F f) {
+  float centerX = roundf((vW-1) / 2.0f);
+  float centerY = roundf((vH-1) / 2.0f);
+  float angleRad = getPinwheelAngle(i, vW, vH); // angle in radians
+  float cosVal = cos_t(angleRad);
+  float sinVal = sin_t(angleRad);
+
+  // avoid re-painting the same pixel
+  int lastX = INT_MIN; // impossible position
+  int lastY = INT_MIN; // impossible position
+  // draw line at angle, starting at center and ending at the segment edge
+  // we use fixed point math for better speed. Starting distance is 0.5 for better rounding
+  // int_fast16_t and int_fast32_t types changed to int, minimum bits commented
+  int posx = (centerX + 0.5f * cosVal) * Fixed_Scale; // X starting position in fixed point 18 bit
+  int posy = (centerY + 0.5f * sinVal) * Fixed_Scale; // Y starting position in fixed point 18 bit
+  int inc_x = cosVal * Fixed_Scale; // X increment per step (fixed point) 10 bit
+  int inc_y = sinVal * Fixed_Scale; // Y increment per step (fixed point) 10 bit
+
+  int32_t maxX = vW * Fixed_Scale; // X edge in fixedpoint
+  int32_t maxY = vH * Fixed_Scale; // Y edge in fixedpoint
+
+  int step = 0;
+  if (jump) {
+    step = pinwheelJump(vW, vH); // can add 2 if using medium pinwheel
+    posx += inc_x * step;
+    posy += inc_y * step;
+  }
+
+  // draw ray until we hit any edge
+  while ((posx >= 0) && (posy >= 0) && (posx < maxX)  && (posy < maxY))  {
+    // scale down to integer (compiler will replace division with appropriate bitshift)
+    int x = posx / Fixed_Scale;
+    int y = posy / Fixed_Scale;
+    // set pixel
+    if (x != lastX || y != lastY) f(x, y, step);  // only paint if pixel position is different
+    lastX = x;
+    lastY = y;
+    // advance to next position
+    posx += inc_x;
+    posy += inc_y;
+    step++;
+  }
+}
+
+// calls f(index) for every pixel buffer index of arc/pinwheel 1D pixel i (only pixels within segment, without repeats)
+template<typename F> static void expand1D2D(uint8_t m12, int i, int vW, int vH, bool jump, F f) {
+  int last[2] = {-1, -1}; // arc visits most pixels twice
+  auto emit = [&](int x, int y) {
+    if (x < 0 || y < 0 || x >= vW || y >= vH) return;
+    int idx = x + y * vW;
+    if (idx == last[0] || idx == last[1]) return;
+    last[1] = last[0];
+    last[0] = idx;
+    f(idx);
+  };
+  if (m12 == M12_pArc) expandArc(i, [&](int x, int y) { emit(x, y); });
+  else                 expandPinwheel(i, vW, vH, jump, [&](int x, int y, int) { emit(x, y); });
+}
+#endif
+
+// (re)builds table of pixel buffer indices for every 1D pixel of arc & pinwheel expansion, used by setPixelColor()
+// layout: offsets[rays+1], (pinwheel only) jump skips[rays], buffer indices
+// table is rebuilt only if expansion or virtual dimensions changed; if there is not enough memory
+// pixels are expanded on the fly (table is an optional speedup)
+// must only be called from loop() (i.e. WS2812FX::service()) or while strip is suspended, after allocatePixels()
+bool Segment::updateMap1D2D() {
+#ifndef WLED_DISABLE_2D
+  if (isActive() && pixels && is2D() && (map1D2D == M12_pArc || map1D2D == M12_sPinwheel)) {
+    const unsigned vW = virtualWidth();
+    const unsigned vH = virtualHeight();
+    const uint32_t key = vW | (vH << 16);
+    if (_m12Key == key && _m12Mode == map1D2D) return _m12Map != nullptr; // nothing changed (do not retry failed allocation)
+    deallocateMap1D2D();
+    _m12Key  = key;
+    _m12Mode = map1D2D;
+    if (_pixelsLen != vW * vH) return false; // buffer does not match geometry
+    const bool pinwheel = map1D2D == M12_sPinwheel;
+    const unsigned rays = virtualLength();
+    const unsigned header = rays + 1 + (pinwheel ? rays : 0);
+    // count entries first
+    unsigned len = header;
+    for (unsigned r = 0; r < rays; r++) expand1D2D(map1D2D, r, vW, vH, false, [&](unsigned) { len++; });
+    if (len > UINT16_MAX) return false;
+    if (ESP.getFreeHeap() < MIN_HEAP_SIZE + len * sizeof(uint16_t)) return false; // not enough memory, expand on the fly
+    // do not use SPI RAM on ESP32 since it is slow
+    _m12Map = (uint16_t*)malloc(len * sizeof(uint16_t));
+    if (!_m12Map) return false;
+    unsigned n = header;
+    for (unsigned r = 0; r < rays; r++) {
+      _m12Map[r] = n;
+      expand1D2D(map1D2D, r, vW, vH, false, [&](unsigned idx) { if (n < len) _m12Map[n++] = idx; });
+      if (pinwheel) {
+        // ray that starts further from center ends with the same pixels as the full ray
+        unsigned tail = 0;
+        expand1D2D(map1D2D, r, vW, vH, true, [&](unsigned) { tail++; });
+        unsigned count = n - _m12Map[r];
+        _m12Map[rays + 1 + r] = count - min(tail, count);
+      }
+    }
+    _m12Map[rays] = n;
+    _m12Len  = len;
+    _m12Rays = rays;
+    return true;
+  }
+#endif
+  deallocateMap1D2D();
+  _m12Key = 0; // never matches an active segment
+  return false;
+}
+
+void Segment::deallocateMap1D2D() {
+  if (_m12Map) free(_m12Map);
+  _m12Map = nullptr;
+  _m12Len = _m12Rays = 0;
+}
+
+#ifndef WLED_DISABLE_2D
+// sets arc/pinwheel 1D pixel i as a plain scatter into pixel buffer (returns false if table does not match current geometry)
+bool IRAM_ATTR_YN Segment::setPixelColor1D2D(int i, uint32_t col, int vW, int vH, bool jump) {
+  if (!_m12Map || !pixels || (unsigned)i >= _m12Rays || _m12Mode != map1D2D || _m12Key != (unsigned(vW) | (unsigned(vH) << 16))) return false;
+  const uint16_t *idx = _m12Map + _m12Map[i];
+  const uint16_t *end = _m12Map + _m12Map[i+1];
+  if (jump) idx += _m12Map[_m12Rays + 1 + i];
+#ifndef WLED_DISABLE_MODE_BLEND
+  // if blending modes, blend with underlying pixel
+  if (_modeBlend) {
+    const uint16_t blend = 0xFFFFU - progress();
+    for (; idx < end; idx++) pixels[*idx] = color_blend(pixels[*idx], col, blend, true);
+    return true;
+  }
+#endif
+  for (; idx < end; idx++) pixels[*idx] = col;
+  return true;
+}
 #endif
 
 // 1D strip
@@ -711,137 +1501,36 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col)
         break;
       case M12_pArc:
         // expand in circular fashion from center
-        if (i==0)
-          setPixelColorXY(0, 0, col);
-        else {
-          float r = i;
-          float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
-          for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
-            int x = roundf(sin_t(rad) * r);
-            int y = roundf(cos_t(rad) * r);
-            // exploit symmetry
-            setPixelColorXY(x, y, col);
-            setPixelColorXY(y, x, col);
-          }
-          // Bresenham’s Algorithm (may not fill every pixel)
-          //int d = 3 - (2*i);
-          //int y = i, x = 0;
-          //while (y >= x) {
-          //  setPixelColorXY(x, y, col);
-          //  setPixelColorXY(y, x, col);
-          //  x++;
-          //  if (d > 0) {
-          //    y--;
-          //    d += 4 * (x - y) + 10;
-          //  } else {
-          //    d += 4 * x + 6;
-          //  }
-          //}
-        }
+        if (!setPixelColor1D2D(i, col, vW, vH)) // use precomputed coordinates if available
+          expandArc(i, [&](int x, int y) { setPixelColorXY(x, y, col); });
         break;
       case M12_pCorner:
         for (int x = 0; x <= i; x++) setPixelColorXY(x, i, col);
         for (int y = 0; y <  i; y++) setPixelColorXY(i, y, col);
         break;
       case M12_sPinwheel: {
-        // i = angle --> 0 - 296  (Big), 0 - 192  (Medium), 0 - 72 (Small)
-        float centerX = roundf((vW-1) / 2.0f);
-        float centerY = roundf((vH-1) / 2.0f);
-        float angleRad = getPinwheelAngle(i, vW, vH); // angle in radians
-        float cosVal = cos_t(angleRad);
-        float sinVal = sin_t(angleRad);
-
-        // avoid re-painting the same pixel
-        int lastX = INT_MIN; // impossible position
-        int lastY = INT_MIN; // impossible position
-        // draw line at angle, starting at center and ending at the segment edge
-        // we use fixed point math for better speed. Starting distance is 0.5 for better rounding
-        // int_fast16_t and int_fast32_t types changed to int, minimum bits commented
-        int posx = (centerX + 0.5f * cosVal) * Fixed_Scale; // X starting position in fixed point 18 bit
-        int posy = (centerY + 0.5f * sinVal) * Fixed_Scale; // Y starting position in fixed point 18 bit
-        int inc_x = cosVal * Fixed_Scale; // X increment per step (fixed point) 10 bit
-        int inc_y = sinVal * Fixed_Scale; // Y increment per step (fixed point) 10 bit
-
-        int32_t maxX = vW * Fixed_Scale; // X edge in fixedpoint
-        int32_t maxY = vH * Fixed_Scale; // Y edge in fixedpoint
-
         // Odd rays start further from center if prevRay started at center.
         static int prevRay = INT_MIN; // previous ray number
-        if ((i % 2 == 1) && (i - 1 == prevRay || i + 1 == prevRay)) {
-          int jump = min(vW/3, vH/3); // can add 2 if using medium pinwheel 
-          posx += inc_x * jump;
-          posy += inc_y * jump;
-        }
+        bool jump = (i % 2 == 1) && (i - 1 == prevRay || i + 1 == prevRay);
         prevRay = i;
-
-        // draw ray until we hit any edge
-        while ((posx >= 0) && (posy >= 0) && (posx < maxX)  && (posy < maxY))  {
-          // scale down to integer (compiler will replace division with appropriate bitshift)
-          int x = posx / Fixed_Scale;
-          int y = posy / Fixed_Scale;
-          // set pixel
-          if (x != lastX || y != lastY) setPixelColorXY(x, y, col);  // only paint if pixel position is different
-          lastX = x;
-          lastY = y;
-          // advance to next position
-          posx += inc_x;
-          posy += inc_y;
-        }
+        if (!setPixelColor1D2D(i, col, vW, vH, jump)) // use precomputed coordinates if available
+          expandPinwheel(i, vW, vH, jump, [&](int x, int y, int) { setPixelColorXY(x, y, col); });
         break;
       }
     }
     return;
-  } else if (Segment::maxHeight!=1 && (width()==1 || height()==1)) {
-    if (start < Segment::maxWidth*Segment::maxHeight) {
-      // we have a vertical or horizontal 1D segment (WARNING: virtual...() may be transposed)
-      int x = 0, y = 0;
-      if (virtualHeight()>1) y = i;
-      if (virtualWidth() >1) x = i;
-      setPixelColorXY(x, y, col);
-      return;
-    }
   }
 #endif
 
-  unsigned len = length();
-  uint8_t _bri_t = currentBri();
-  if (_bri_t < 255) {
-    col = color_fade(col, _bri_t);
-  }
-
-  // expand pixel (taking into account start, grouping, spacing [and offset])
-  i = i * groupLength();
-  if (reverse) { // is segment reversed?
-    if (mirror) { // is segment mirrored?
-      i = (len - 1) / 2 - i;  //only need to index half the pixels
-    } else {
-      i = (len - 1) - i;
-    }
-  }
-  i += start; // starting pixel in a group
-
-  uint32_t tmpCol = col;
-  // set all the pixels in the group
-  for (int j = 0; j < grouping; j++) {
-    unsigned indexSet = i + ((reverse) ? -j : j);
-    if (indexSet >= start && indexSet < stop) {
-      if (mirror) { //set the corresponding mirrored pixel
-        unsigned indexMir = stop - indexSet + start - 1;
-        indexMir += offset; // offset/phase
-        if (indexMir >= stop) indexMir -= len; // wrap
+  // 1D segment (or vertical/horizontal 1D segment in matrix, which has the same buffer layout since
+  // one of its virtual dimensions is 1); expansion onto the strip is done in WS2812FX::blendSegment()
+  if (!pixels) { setPixelColorDirect(i, col); return; } // not enough RAM for pixel buffer
+  if ((unsigned)i >= _pixelsLen) return; // buffer does not match geometry
 #ifndef WLED_DISABLE_MODE_BLEND
-        if (_modeBlend) tmpCol = color_blend(strip.getPixelColor(indexMir), col, 0xFFFFU - progress(), true);
+  // if blending modes, blend with underlying pixel
+  if (_modeBlend) col = color_blend(pixels[i], col, 0xFFFFU - progress(), true);
 #endif
-        strip.setPixelColor(indexMir, tmpCol);
-      }
-      indexSet += offset; // offset/phase
-      if (indexSet >= stop) indexSet -= len; // wrap
-#ifndef WLED_DISABLE_MODE_BLEND
-      if (_modeBlend) tmpCol = color_blend(strip.getPixelColor(indexSet), col, 0xFFFFU - progress(), true);
-#endif
-      strip.setPixelColor(indexSet, tmpCol);
-    }
-  }
+  pixels[i] = col;
 }
 
 #ifdef WLED_USE_AA_PIXELS
@@ -942,13 +1631,134 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColor(int i) const
   }
 #endif
 
-  if (reverse) i = virtualLength() - i - 1;
-  i *= groupLength();
-  i += start;
-  // offset/phase
-  i += offset;
-  if (i >= stop) i -= length();
-  return strip.getPixelColor(i);
+  if (!pixels) return getPixelColorDirect(i);
+  if ((unsigned)i >= _pixelsLen) return 0;
+  return pixels[i];
+}
+
+// clips span of len pixels starting at virtual pixel (x,y) running along a row (or a column if vertical)
+// returns pointer to the first pixel of clipped span within pixel buffer (nullptr if span is outside of segment)
+// len is reduced to the number of pixels within segment, skip is set to the number of clipped leading pixels
+uint32_t *Segment::clipSpan(int x, int y, int &len, int &skip, bool vertical, unsigned &stride) const {
+  skip = 0;
+  if (!isActive() || !pixels || len <= 0) return nullptr;
+  int cols, rows;
+  if (is2D()) {
+    cols = virtualWidth();
+    rows = virtualHeight();
+    if (unsigned(cols * rows) > _pixelsLen) return nullptr; // buffer does not match geometry
+  } else {
+    cols = min((unsigned)virtualLength(), (unsigned)_pixelsLen); // 1D segment is a single row
+    rows = 1;
+  }
+  const int across = vertical ? x : y;
+  if (across < 0 || across >= (vertical ? cols : rows)) return nullptr;
+  int &pos = vertical ? y : x;
+  const int along = vertical ? rows : cols;
+  if (pos < 0) { skip = -pos; len -= skip; pos = 0; }
+  if (pos + len > along) len = along - pos;
+  if (len <= 0) return nullptr;
+  stride = vertical ? cols : 1;
+  return pixels + x + y * cols;
+}
+
+// used instead of clipSpan() if segment has no pixel buffer
+int Segment::spanIndex(int x, int y, int i, bool vertical) const {
+  const int cols = is2D() ? virtualWidth() : virtualLength();
+  const int rows = is2D() ? virtualHeight() : 1; // 1D segment is a single row
+  if (vertical) y += i;
+  else          x += i;
+  if (x < 0 || y < 0 || x >= cols || y >= rows) return -1;
+  return x + y * cols;
+}
+
+int Segment::getPixelSpan(int x, int y, uint32_t *buf, int len, bool vertical) const {
+  if (len > 0) memset(buf, 0, len * sizeof(uint32_t));
+  if (isActive() && !pixels) { // not enough RAM for pixel buffer, read from strip
+    int n = 0;
+    for (int i = 0; i < len; i++) {
+      int v = spanIndex(x, y, i, vertical);
+      if (v >= 0) { buf[i] = getPixelColorDirect(v); n++; }
+    }
+    return n;
+  }
+  int skip;
+  unsigned stride;
+  const uint32_t *px = clipSpan(x, y, len, skip, vertical, stride);
+  if (!px) return 0;
+  buf += skip;
+  for (int i = 0; i < len; i++, px += stride) buf[i] = *px;
+  return len;
+}
+
+void Segment::setPixelSpan(int x, int y, const uint32_t *buf, int len, bool vertical) {
+  if (isActive() && !pixels) { // not enough RAM for pixel buffer, draw onto strip
+    for (int i = 0; i < len; i++) {
+      int v = spanIndex(x, y, i, vertical);
+      if (v >= 0) setPixelColorDirect(v, buf[i]);
+    }
+    return;
+  }
+  int skip;
+  unsigned stride;
+  uint32_t *px = clipSpan(x, y, len, skip, vertical, stride);
+  if (!px) return;
+  buf += skip;
+  for (int i = 0; i < len; i++, px += stride) setSpanPixel(px, buf[i]);
+}
+
+void Segment::fillSpan(int x, int y, int len, uint32_t c, bool vertical) {
+  if (isActive() && !pixels) { // not enough RAM for pixel buffer, draw onto strip
+    for (int i = 0; i < len; i++) {
+      int v = spanIndex(x, y, i, vertical);
+      if (v >= 0) setPixelColorDirect(v, c);
+    }
+    return;
+  }
+  int skip;
+  unsigned stride;
+  uint32_t *px = clipSpan(x, y, len, skip, vertical, stride);
+  if (!px) return;
+  for (int i = 0; i < len; i++, px += stride) setSpanPixel(px, c);
+}
+
+// blurs len pixels read by get(i) and written by set(i, c), source: FastLED colorutils.cpp
+template<typename G, typename S> static void blurPixels(int len, uint8_t keep, uint8_t seep, G get, S set) {
+  uint32_t carryover = BLACK;
+  uint32_t lastnew = BLACK;
+  for (int i = 0; i < len; i++) {
+    uint32_t cur = get(i);
+    uint32_t part = color_fade(cur, seep);
+    uint32_t curnew = color_fade(cur, keep);
+    if (i > 0) {
+      if (carryover) curnew = color_add(curnew, carryover, true);
+      uint32_t prev = color_add(lastnew, part, true);
+      // optimization: only set pixel if color has changed (previous pixel still holds its original value)
+      if (get(i - 1) != prev) set(i - 1, prev);
+    }
+    lastnew = curnew;
+    carryover = part;
+  }
+  if (len > 0) set(len - 1, lastnew); // set last pixel
+}
+
+// blurs span of pixels in place
+void Segment::blurSpan(uint32_t *px, int len, unsigned stride, uint8_t keep, uint8_t seep) {
+  blurPixels(len, keep, seep, [&](int i) { return px[i * stride]; }, [&](int i, uint32_t c) { setSpanPixel(px + i * stride, c); });
+}
+
+// blurs len pixels of a row (or column if vertical) starting at (x,y)
+void Segment::blurLine(int x, int y, int len, bool vertical, uint8_t keep, uint8_t seep) {
+  if (!pixels) { // not enough RAM for pixel buffer, blur pixels on strip
+    while (len > 0 && spanIndex(x, y, len - 1, vertical) < 0) len--;
+    blurPixels(len, keep, seep, [&](int i) { return getPixelColorDirect(spanIndex(x, y, i, vertical)); },
+                                [&](int i, uint32_t c) { setPixelColorDirect(spanIndex(x, y, i, vertical), c); });
+    return;
+  }
+  int skip;
+  unsigned stride;
+  uint32_t *px = clipSpan(x, y, len, skip, vertical, stride);
+  if (px) blurSpan(px, len, stride, keep, seep);
 }
 
 uint8_t Segment::differs(Segment& b) const {
@@ -1032,11 +1842,8 @@ void Segment::refreshLightCapabilities() {
 void Segment::fill(uint32_t c) {
   if (!isActive()) return; // not active
   const int cols = is2D() ? virtualWidth() : virtualLength();
-  const int rows = virtualHeight(); // will be 1 for 1D
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    if (is2D()) setPixelColorXY(x, y, c);
-    else        setPixelColor(x, c);
-  }
+  const int rows = is2D() ? virtualHeight() : 1; // 1D segment is a single row
+  for (int y = 0; y < rows; y++) fillSpan(0, y, cols, c);
 }
 
 /*
@@ -1045,20 +1852,18 @@ void Segment::fill(uint32_t c) {
 void Segment::fade_out(uint8_t rate) {
   if (!isActive()) return; // not active
   const int cols = is2D() ? virtualWidth() : virtualLength();
-  const int rows = virtualHeight(); // will be 1 for 1D
+  const int rows = is2D() ? virtualHeight() : 1; // 1D segment is a single row
 
   rate = (255-rate) >> 1;
   float mappedRate = 1.0f / (float(rate) + 1.1f);
 
-  uint32_t color = colors[1]; // SEGCOLOR(1); // target color
-  int w2 = W(color);
-  int r2 = R(color);
-  int g2 = G(color);
-  int b2 = B(color);
+  const uint32_t target = colors[1]; // SEGCOLOR(1); // target color
+  const int w2 = W(target);
+  const int r2 = R(target);
+  const int g2 = G(target);
+  const int b2 = B(target);
 
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    color = is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
-    if (color == colors[1]) continue; // already at target color
+  auto fade = [&](uint32_t color) -> uint32_t {
     int w1 = W(color);
     int r1 = R(color);
     int g1 = G(color);
@@ -1075,8 +1880,23 @@ void Segment::fade_out(uint8_t rate) {
     gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
     bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
 
-    if (is2D()) setPixelColorXY(x, y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
-    else        setPixelColor(x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    return RGBW32(r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+  };
+
+  if (!pixels) { // not enough RAM for pixel buffer, fade pixels on strip
+    for (int v = 0; v < cols * rows; v++) setPixelColorDirect(v, fade(getPixelColorDirect(v)));
+    return;
+  }
+  for (int y = 0; y < rows; y++) {
+    int len = cols;
+    int skip;
+    unsigned stride;
+    uint32_t *px = clipSpan(0, y, len, skip, false, stride);
+    if (!px) return;
+    for (int x = 0; x < len; x++, px += stride) {
+      if (*px == target) continue; // already at target color
+      setSpanPixel(px, fade(*px));
+    }
   }
 }
 
@@ -1084,11 +1904,25 @@ void Segment::fade_out(uint8_t rate) {
 void Segment::fadeToBlackBy(uint8_t fadeBy) {
   if (!isActive() || fadeBy == 0) return;   // optimization - no scaling to apply
   const int cols = is2D() ? virtualWidth() : virtualLength();
-  const int rows = virtualHeight(); // will be 1 for 1D
+  const int rows = is2D() ? virtualHeight() : 1; // 1D segment is a single row
 
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    if (is2D()) setPixelColorXY(x, y, color_fade(getPixelColorXY(x,y), 255-fadeBy));
-    else        setPixelColor(x, color_fade(getPixelColor(x), 255-fadeBy));
+  if (!pixels) { // not enough RAM for pixel buffer, fade pixels on strip
+    for (int v = 0; v < cols * rows; v++) setPixelColorDirect(v, color_fade(getPixelColorDirect(v), 255-fadeBy));
+    return;
+  }
+  for (int y = 0; y < rows; y++) {
+    int len = cols;
+    int skip;
+    unsigned stride;
+    uint32_t *px = clipSpan(0, y, len, skip, false, stride);
+    if (!px) return;
+#ifndef WLED_DISABLE_MODE_BLEND
+    if (_modeBlend) {
+      for (int x = 0; x < len; x++) setSpanPixel(px + x, color_fade(px[x], 255-fadeBy));
+      continue;
+    }
+#endif
+    fadeSpan(px, len, 255-fadeBy); // rows are contiguous in pixel buffer
   }
 }
 
@@ -1107,27 +1941,7 @@ void Segment::blur(uint8_t blur_amount, bool smear) {
 #endif
   uint8_t keep = smear ? 255 : 255 - blur_amount;
   uint8_t seep = blur_amount >> (1 + smear);
-  unsigned vlength = virtualLength();
-  uint32_t carryover = BLACK;
-  uint32_t lastnew;
-  uint32_t last;
-  uint32_t curnew = BLACK;
-  for (unsigned i = 0; i < vlength; i++) {
-    uint32_t cur = getPixelColor(i);
-    uint32_t part = color_fade(cur, seep);
-    curnew = color_fade(cur, keep);
-    if (i > 0) {
-      if (carryover) curnew = color_add(curnew, carryover, true);
-      uint32_t prev = color_add(lastnew, part, true);
-      // optimization: only set pixel if color has changed
-      if (last != prev) setPixelColor(i - 1, prev);
-    } else // first pixel
-      setPixelColor(i, curnew);
-    lastnew = curnew;
-    last = cur; // save original value for comparison on next iteration
-    carryover = part;
-  }
-  setPixelColor(vlength - 1, curnew);
+  blurLine(0, 0, virtualLength(), false, keep, seep);
 }
 
 /*
@@ -1169,6 +1983,37 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   if (mapping && virtualLength() > 1) paletteIndex = (i*255)/(virtualLength() -1);
   // paletteBlend: 0 - wrap when moving, 1 - always wrap, 2 - never wrap, 3 - none (undefined)
   if (!wrap && strip.paletteBlend != 3) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
+#ifdef WLED_PALETTE_LUT
+  const bool noBlend = strip.paletteBlend == 3;
+  if (!_paletteLUTValid || _paletteLUTNoBlend != noBlend) {
+    // expand palette only if it is used often enough to pay off
+    if (_paletteLUTHits < PALETTE_LUT_THRESHOLD) _paletteLUTHits++;
+    else {
+      for (unsigned k = 0; k < 256; k++) _paletteLUT[k] = ColorFromPalette(_currentPalette, k, 255, noBlend ? NOBLEND : LINEARBLEND);
+      _paletteLUTNoBlend = noBlend;
+      _paletteLUTValid   = true;
+    }
+  }
+  if (_paletteLUTValid && _paletteLUTNoBlend == noBlend) {
+    CRGB c = _paletteLUT[paletteIndex & 0xFF];
+    // same brightness scaling as ColorFromPalette()
+    if (pbri != 255) {
+      if (pbri) {
+        unsigned b = pbri + 1;
+        #if FASTLED_SCALE8_FIXED == 1
+        if (c.r) c.r = scale8(c.r, b);
+        if (c.g) c.g = scale8(c.g, b);
+        if (c.b) c.b = scale8(c.b, b);
+        #else
+        if (c.r) c.r = scale8(c.r, b) + 1;
+        if (c.g) c.g = scale8(c.g, b) + 1;
+        if (c.b) c.b = scale8(c.b, b) + 1;
+        #endif
+      } else c = CRGB::Black;
+    }
+    return RGBW32(c.r, c.g, c.b, W(color));
+  }
+#endif
   CRGB fastled_col = ColorFromPalette(_currentPalette, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
 
   return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, W(color));
@@ -1274,6 +2119,7 @@ void WS2812FX::finalizeInit() {
       if (BusManager::add(defCfg) == -1) break;
     }
   }
+  BusManager::allocateFrameBuffer(); // all buses are known now
 
   _length = 0;
   for (int i=0; i<BusManager::getNumBusses(); i++) {
@@ -1304,106 +2150,288 @@ void WS2812FX::finalizeInit() {
 void WS2812FX::service() {
   unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
   now = nowUp + timebase;
+  // poll for end of transfer on every call (not only when a frame is due) so that PERF_WIRE and _showDone are accurate
+  if (_showBusy && BusManager::canAllShow()) { // previous frame is out
+    _showBusy = false;
+    _showDone = micros();
+    PerfCounters::record(PERF_WIRE, _showStart);
+  }
   if (nowUp - _lastShow < MIN_SHOW_DELAY || _suspend) return;
+  // composited frame is waiting for buses: swap it in once they are done, do not render over it meanwhile
+  if (_showPending) {
+    if (!BusManager::canAllShow()) return;
+    show();
+    return;
+  }
   bool doShow = false;
+  uint32_t perfFrame = PerfCounters::start();
+
+  Segment::compactData(); // if effect data arena got fragmented in previous frame (no effect is running now)
 
   _isServicing = true;
-  _segment_index = 0;
 
-  for (segment &seg : _segments) {
-    if (_suspend) return; // immediately stop processing segments if suspend requested during service()
+  uint8_t  due[MAX_NUM_SEGMENTS]; // segments whose deadline (next_time) has passed
+  unsigned numDue = 0;
+  for (_segment_index = 0; _segment_index < _segments.size() && _segment_index < MAX_NUM_SEGMENTS; _segment_index++) {
+    segment &seg = _segments[_segment_index];
+    if (_suspend) { // immediately stop processing segments if suspend requested during service()
+      for (segment &s : _segments) s.endFrame();
+      return;
+    }
 
+    seg.beginFrame(nowUp); // capture per-frame render context (transition progress, brightness, colors)
     // process transition (mode changes in the middle of transition)
     seg.handleTransition();
     // reset the segment runtime data if needed
     seg.resetIfRequired();
 
     if (!seg.isActive()) continue;
+    seg.allocatePixels(); // (re)allocate pixel buffer if segment geometry changed
+    seg.applyStagedPixels(); // pixels set through JSON API
+    seg.updateMap();      // rebuild virtual to physical index table if segment geometry or ledmap changed
+    seg.updateMap1D2D();  // rebuild arc/pinwheel expansion table if expansion or dimensions changed
 
-    // last condition ensures all solid segments are updated at the same time
-    if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
-    {
+    if (nowUp > seg.next_time || _triggered) {
       doShow = true;
-      unsigned frameDelay = FRAMETIME;
-
-      if (!seg.freeze) { //only run effect function if not frozen
-        int oldCCT = BusManager::getSegmentCCT(); // store original CCT value (actually it is not Segment based)
-        _virtualSegmentLength = seg.virtualLength(); //SEGLEN
-        _colors_t[0] = gamma32(seg.currentColor(0));
-        _colors_t[1] = gamma32(seg.currentColor(1));
-        _colors_t[2] = gamma32(seg.currentColor(2));
-        seg.setCurrentPalette();              // load actual palette
-        // when correctWB is true we need to correct/adjust RGB value according to desired CCT value, but it will also affect actual WW/CW ratio
-        // when cctFromRgb is true we implicitly calculate WW and CW from RGB values
-        if (cctFromRgb) BusManager::setSegmentCCT(-1);
-        else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
-        // Effect blending
-        // When two effects are being blended, each may have different segment data, this
-        // data needs to be saved first and then restored before running previous mode.
-        // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
-        [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
-        frameDelay = (*_mode[seg.mode])();         // run new/current mode
-#ifndef WLED_DISABLE_MODE_BLEND
-        if (modeBlending && seg.mode != tmpMode) {
-          Segment::tmpsegd_t _tmpSegData;
-          Segment::modeBlend(true);           // set semaphore
-          seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
-          _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
-          unsigned d2 = (*_mode[tmpMode])();  // run old mode
-          seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
-          frameDelay = min(frameDelay,d2);              // use shortest delay
-          Segment::modeBlend(false);          // unset semaphore
-        }
-#endif
-        seg.call++;
-        if (seg.isInTransition() && frameDelay > FRAMETIME) frameDelay = FRAMETIME; // force faster updates during transition
-        BusManager::setSegmentCCT(oldCCT); // restore old CCT for ABL adjustments
-      }
-
-      seg.next_time = nowUp + frameDelay;
+      if (seg.freeze) seg.next_time = nowUp + FRAMETIME; // only run effect function if not frozen
+      else            due[numDue++] = _segment_index;
+    }
+  }
+  // ensure all solid segments are updated at the same time
+  if (doShow) for (unsigned i = 0; i < _segments.size() && numDue < MAX_NUM_SEGMENTS; i++) {
+    const segment &seg = _segments[i];
+    if (seg.isActive() && !seg.freeze && seg.mode == FX_MODE_STATIC && !(nowUp > seg.next_time || _triggered)) due[numDue++] = i;
+  }
+  // most overdue segment first (segments render into their own buffers so order does not matter for output)
+  for (unsigned i = 1; i < numDue; i++) {
+    for (unsigned j = i; j > 0 && long(_segments[due[j]].next_time - _segments[due[j-1]].next_time) < 0; j--) std::swap(due[j], due[j-1]);
+  }
+
+  // render due segments within frame budget; a segment that does not fit is postponed to next frame
+  // (where it is most overdue and goes first), so light segments keep their frame rate next to heavy ones
+  const uint32_t budget = getFrameBudgetUs();
+  uint32_t spent = 0;
+  unsigned rendered = 0, postponed = 0;
+  int heaviest = -1;
+  for (unsigned k = 0; k < numDue; k++) {
+    if (_suspend || due[k] >= _segments.size()) { // immediately stop processing segments if suspend requested during service()
+      for (segment &s : _segments) s.endFrame();
+      return;
+    }
+    segment &seg = _segments[due[k]];
+    if (budget && rendered && spent + seg.sched.cost > budget) {
+      seg.sched.missed++;
+      postponed++;
+      continue;
     }
-    _segment_index++;
+    uint32_t start = micros();
+    unsigned frameDelay = renderSegment(due[k]);
+    uint32_t cost = micros() - start;
+    if (cost > UINT16_MAX) cost = UINT16_MAX;
+    spent += cost;
+    rendered++;
+    seg.sched.cost = (seg.sched.cost * 7 + cost + 4) / 8; // moving average
+    if (seg.sched.frames < UINT8_MAX) seg.sched.frames++;
+    if (heaviest < 0 || seg.sched.cost > _segments[heaviest].sched.cost) heaviest = due[k];
+    if (seg.isInTransition() && frameDelay > FRAMETIME) frameDelay = FRAMETIME; // force faster updates during transition
+    seg.next_time = nowUp + frameDelay + seg.sched.delay;
+  }
+  _renderTime = spent;
+
+  // degrade gracefully: if other segments suffer, slow down the heaviest one (relax when there is room again)
+  if (budget && (postponed || (rendered > 1 && spent > budget))) {
+    if (heaviest >= 0 && _segments[heaviest].sched.delay < 250) _segments[heaviest].sched.delay += 2;
+  } else if (spent < budget * 3 / 4) {
+    for (segment &seg : _segments) if (seg.sched.delay) seg.sched.delay--;
+  }
+  if (nowUp - _schedSecond >= 1000) {
+    for (segment &seg : _segments) { seg.sched.fps = seg.sched.frames; seg.sched.frames = 0; }
+    _schedSecond = nowUp;
   }
   _virtualSegmentLength = 0;
   _isServicing = false;
   _triggered = false;
 
   #ifdef WLED_DEBUG
-  if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow effects %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
+  if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow effects %u/%d (%u postponed).\n"), (unsigned)(millis()-nowUp), (int)_frametime, postponed);
   #endif
   if (doShow) {
     yield();
     Segment::handleRandomPalette(); // slowly transition random palette; move it into for loop when each segment has individual random palette
-    show();
+    for (const segment &seg : _segments) blendSegment(seg); // composite all segments (in order) onto the strip
+    // buses still sending previous frame: do not block, next service() call swaps frame in when they are done
+    if (BusManager::canAllShow()) show();
+    else _showPending = true;
+    #ifndef WLED_DISABLE_MODE_BLEND
+    bool blending = false;
+    for (const segment &seg : _segments) blending |= seg.hasTransitionPixels();
+    if (_pixelsBlend && !blending) {
+      free(_pixelsBlend); // no effect transitions left
+      _pixelsBlend = nullptr;
+      _pixelsBlendLen = 0;
+    }
+    #endif
+    PerfCounters::commit(PERF_BLEND);
+    PerfCounters::record(PERF_FRAME, perfFrame);
   }
+  for (segment &seg : _segments) seg.endFrame(); // segment values may change between frames (UI, transitions)
   #ifdef WLED_DEBUG
   if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow strip %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
   #endif
 }
 
+// runs effect function of segment n (and previous effect while blending modes) into segment's pixel buffer
+// sets up SEGMENT/SEGENV/SEGLEN/SEGCOLOR context, returns delay requested by effect
+uint16_t WS2812FX::renderSegment(uint8_t n) {
+  if (n >= _segments.size()) return FRAMETIME;
+  Segment &seg = _segments[n];
+  _segment_index = n;
+  _virtualSegmentLength = seg.virtualLength(); //SEGLEN
+  _colors_t[0] = gamma32(seg.currentColor(0));
+  _colors_t[1] = gamma32(seg.currentColor(1));
+  _colors_t[2] = gamma32(seg.currentColor(2));
+  seg.setCurrentPalette();              // load actual palette
+  // Effect blending
+  // When two effects are being blended, each may have different segment data, this
+  // data needs to be saved first and then restored before running previous mode.
+  // Previous mode draws into its own pixel buffer; both buffers are composed in blendSegment() according
+  // to blendingStyle. If there is not enough memory for additional buffer, previous mode draws over
+  // the new one, blending each pixel with the underlying one (result depends on effect behaviour).
+  [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
+#ifndef WLED_DISABLE_MODE_BLEND
+  const bool blendModes = modeBlending && seg.mode != tmpMode;
+  const bool ownPixels  = blendModes && seg.allocateTransitionPixels(); // before new mode draws into pixel buffer
+#endif
+  // segment without pixel buffer draws directly onto the strip, buses need its CCT (see blendSegment())
+  const int oldCCT = BusManager::getSegmentCCT();
+  if (!seg.pixels) {
+    if (cctFromRgb) BusManager::setSegmentCCT(-1);
+    else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
+  }
+  uint32_t perf = PerfCounters::start();
+  unsigned frameDelay = (*_mode[seg.mode])();         // run new/current mode
+  PerfCounters::record(PERF_SEGMENT + n, perf);
+#ifndef WLED_DISABLE_MODE_BLEND
+  if (blendModes) {
+    perf = PerfCounters::start();
+    Segment::tmpsegd_t _tmpSegData;
+    if (ownPixels) seg.swapTransitionPixels();  // previous mode draws into its own buffer
+    else           Segment::modeBlend(true);    // set semaphore
+    seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
+    _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
+    unsigned d2 = (*_mode[tmpMode])();  // run old mode
+    seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
+    frameDelay = min(frameDelay,d2);    // use shortest delay
+    if (ownPixels) seg.swapTransitionPixels();
+    else           Segment::modeBlend(false);   // unset semaphore
+    PerfCounters::accumulate(PERF_BLEND, perf);
+  }
+#endif
+  if (!seg.pixels) BusManager::setSegmentCCT(oldCCT);
+  seg.call++;
+  return frameDelay;
+}
+
 void IRAM_ATTR WS2812FX::setPixelColor(unsigned i, uint32_t col) {
   i = getMappedPixelIndex(i);
   if (i >= _length) return;
   BusManager::setPixelColor(i, col);
 }
 
+// hands whole span to buses at once unless a ledmap needs to be applied to each pixel
+// raw is used by realtime direct output (buses skip auto white & white balance)
+void IRAM_ATTR WS2812FX::setPixels(unsigned start, unsigned count, const uint32_t *c, bool raw) {
+  if (customMappingSize && (realtimeMode == REALTIME_MODE_INACTIVE || realtimeRespectLedMaps)) {
+    for (unsigned i = 0; i < count; i++) {
+      unsigned pix = getMappedPixelIndex(start + i);
+      if (pix >= _length) continue;
+      if (raw) BusManager::setPixels(pix, 1, c + i, true);
+      else     BusManager::setPixelColor(pix, c[i]);
+    }
+    return;
+  }
+  if (start >= _length) return;
+  if (count > _length - start) count = _length - start;
+  BusManager::setPixels(start, count, c, raw);
+}
+
 uint32_t IRAM_ATTR WS2812FX::getPixelColor(unsigned i) const {
   i = getMappedPixelIndex(i);
   if (i >= _length) return 0;
   return BusManager::getPixelColor(i);
 }
 
+// expands segment's pixel buffer onto the strip, applying opacity, grouping, spacing, reverse, mirror, transpose and offset
+// each virtual pixel is faded only once; segments are composited in order so later segments overwrite earlier ones
+// uses segment's precomputed index table when available, otherwise expands pixels on the fly
+void WS2812FX::blendSegment(const Segment &seg) {
+  if (!seg.isActive() || !seg.pixels) return;
+
+  // when correctWB is true we need to correct/adjust RGB value according to desired CCT value, but it will also affect actual WW/CW ratio
+  // when cctFromRgb is true we implicitly calculate WW and CW from RGB values
+  int oldCCT = BusManager::getSegmentCCT(); // store original CCT value (actually it is not Segment based)
+  if (cctFromRgb) BusManager::setSegmentCCT(-1);
+  else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
+
+  const uint32_t *pixels = seg.pixels;
+#ifndef WLED_DISABLE_MODE_BLEND
+  // effect transition: compose current and previous effect first
+  if (seg.hasTransitionPixels()) {
+    if (_pixelsBlendLen < seg.pixelsSize()) {
+      if (_pixelsBlend) free(_pixelsBlend);
+      _pixelsBlendLen = 0;
+      _pixelsBlend = (uint32_t*)malloc(seg.pixelsSize() * sizeof(uint32_t));
+      if (_pixelsBlend) _pixelsBlendLen = seg.pixelsSize();
+    }
+    if (_pixelsBlend) {
+      uint32_t perf = PerfCounters::start();
+      seg.blendTransition(_pixelsBlend);
+      pixels = _pixelsBlend;
+      PerfCounters::accumulate(PERF_BLEND, perf);
+    }
+  }
+#endif
+
+  const uint8_t bri = seg.currentBri();
+  uint32_t lastV = UINT32_MAX;
+  uint32_t col = 0;
+  auto fetch = [&](uint32_t v) { // fade each virtual pixel only once (entries are in virtual pixel order)
+    if (v != lastV) {
+      lastV = v;
+      col = pixels[v];
+      if (bri < 255) col = color_fade(col, bri);
+    }
+    return col;
+  };
+
+  const Segment::pxmap_t *map = seg.getMap(); // precomputed index table (if it matches current geometry & ledmap)
+  if (map && (customMappingSize == 0 || realtimeMode == REALTIME_MODE_INACTIVE || realtimeRespectLedMaps)) {
+    Bus *bus = BusManager::getBusForRange(seg.mapFirst(), seg.mapLast());
+    if (bus) { // segment fits into a single bus, no need to look up bus for each pixel
+      const unsigned bstart = bus->getStart();
+      for (unsigned k = 0; k < seg.mapSize(); k++) bus->setPixelColor(map[k].p - bstart, fetch(map[k].v));
+    } else
+      for (unsigned k = 0; k < seg.mapSize(); k++) BusManager::setPixelColor(map[k].p, fetch(map[k].v));
+  } else {
+    unsigned vLen = seg.inMatrix() ? seg.virtualWidth() * seg.virtualHeight() : seg.virtualLength();
+    if (vLen == seg.pixelsSize()) // buffer matches current geometry
+      expandSegment(seg, [&](unsigned v, unsigned i) { setPixelColor(i, fetch(v)); });
+  }
+  BusManager::setSegmentCCT(oldCCT); // restore old CCT for ABL adjustments
+}
+
 void WS2812FX::show() {
   // avoid race condition, capture _callback value
   show_callback callback = _callback;
   if (callback) callback();
+  _showPending = false;
 
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
   BusManager::show();
+  _showStart = PerfCounters::start();
+  _showBusy  = true;
 
   unsigned long showNow = millis();
   size_t diff = showNow - _lastShow;
@@ -1432,6 +2460,12 @@ uint16_t WS2812FX::getFps() const {
   return (FPS_MULTIPLIER * _cumulativeFps) >> FPS_CALC_SHIFT; // _cumulativeFps is stored in fixed point
 }
 
+// sets % of frame time effects may use before segments get postponed or slowed down (0 disables frame budget)
+void WS2812FX::setFrameBudget(uint8_t pct) {
+  _frameBudget = min(pct, (uint8_t)100);
+  if (_frameBudget == 0) for (segment &seg : _segments) seg.sched.delay = 0;
+}
+
 void WS2812FX::setTargetFps(uint8_t fps) {
   if (fps > 0 && fps <= 120) _targetFps = fps;
   _frametime = 1000 / _targetFps;
@@ -1806,6 +2840,7 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
   customMappingSize = 0; // prevent use of mapping if anything goes wrong
   currentLedmap = 0;
+  _mapGeneration++;      // segment index tables need to be rebuilt
   if (n == 0 || isFile) interfaceUpdateCallMode = CALL_MODE_WS_SEND; // schedule WS update (to inform UI)
 
   if (!isFile && n==0 && isMatrix) {
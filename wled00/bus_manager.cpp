@@ -20,6 +20,7 @@
 #include "pin_manager.h"
 #include "bus_wrapper.h"
 #include "bus_manager.h"
+#include "perf.h"
 
 extern bool cctICused;
 
@@ -27,7 +28,7 @@ extern bool cctICused;
 uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb);
 
 //udp.cpp
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, const IPAddress *clients, netstats_t **stats, uint8_t numClients, uint16_t length, const byte *buffer, uint8_t bri=255, bool isRGBW=false);
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -63,6 +64,7 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte
 bool ColorOrderMap::add(uint16_t start, uint16_t len, uint8_t colorOrder) {
   if (count() >= WLED_MAX_COLOR_ORDER_MAPPINGS || len == 0 || (colorOrder & 0x0F) > COL_ORDER_MAX) return false; // upper nibble contains W swap information
   _mappings.push_back({start,len,colorOrder});
+  _version++;
   return true;
 }
 
@@ -77,6 +79,30 @@ uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaul
   return defaultColorOrder;
 }
 
+uint8_t ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder, uint16_t &runEnd) const {
+  // order stays the same until pix reaches start or end of any mapping
+  unsigned end = UINT16_MAX;
+  for (unsigned i = 0; i < count(); i++) {
+    unsigned mstart = _mappings[i].start;
+    unsigned mend   = mstart + _mappings[i].len;
+    if (mstart > pix && mstart < end) end = mstart;
+    if (pix >= mstart && pix < mend && mend < end) end = mend;
+  }
+  runEnd = end;
+  return getPixelColorOrder(pix, defaultColorOrder);
+}
+
+
+// WW/CW ratios for each relative CCT value, rebuilt when blending changes
+void Bus::buildCCTTable() {
+  //0 - linear (CCT 127 = 50% warm, 50% cold), 127 - additive CCT blending (CCT 127 = 100% warm, 100% cold)
+  for (unsigned cct = 0; cct < 256; cct++) {
+    unsigned ww = cct       < _cctBlend ? 255 : ((255-cct) * 255) / (255 - _cctBlend);
+    unsigned cw = (255-cct) < _cctBlend ? 255 : (cct * 255) / (255 - _cctBlend);
+    _cctTable[cct] = (cw << 8) | ww;
+  }
+  _cctTableBlend = _cctBlend;
+}
 
 void Bus::calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw) {
   unsigned cct = 0; //0 - full warm white, 255 - full cold white
@@ -89,14 +115,11 @@ void Bus::calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw) {
     cct = (approximateKelvinFromRGB(c) - 1900) >> 5;  // convert K (from RGB value) to relative format
   }
   
-  //0 - linear (CCT 127 = 50% warm, 50% cold), 127 - additive CCT blending (CCT 127 = 100% warm, 100% cold)
-  if (cct       < _cctBlend) ww = 255;
-  else                       ww = ((255-cct) * 255) / (255 - _cctBlend);
-  if ((255-cct) < _cctBlend) cw = 255;
-  else                       cw = (cct * 255) / (255 - _cctBlend);
+  if (_cctTableBlend != _cctBlend) buildCCTTable();
+  uint16_t ratio = _cctTable[cct > 255 ? 255 : cct];
 
-  ww = (w * ww) / 255; //brightness scaling
-  cw = (w * cw) / 255;
+  ww = (w * (ratio & 0xFF)) / 255; //brightness scaling
+  cw = (w * (ratio >> 8))   / 255;
 }
 
 uint32_t Bus::autoWhiteCalc(uint32_t c) const {
@@ -121,6 +144,34 @@ uint8_t *Bus::allocateData(size_t size) {
 }
 
 
+// split bus (including skipped pixels) into runs with the same color order so show() does not need to search the map
+void BusDigital::compileColorOrder() {
+  _coRanges.clear();
+  const unsigned len = _len + _skip;
+  unsigned pix = 0;
+  while (pix < len) {
+    uint16_t runEnd;
+    uint8_t co = _colorOrderMap.getPixelColorOrder(pix + _start, _colorOrder, runEnd);
+    pix = min(len, unsigned(runEnd - _start));
+    if (!_coRanges.empty() && _coRanges.back().colorOrder == co) _coRanges.back().end = pix; // merge adjacent mappings with the same order
+    else _coRanges.push_back({uint16_t(pix), co});
+  }
+  _coVersion = _colorOrderMap.version();
+  _coLast = 0;
+}
+
+uint8_t IRAM_ATTR BusDigital::colorOrderAt(unsigned pix) {
+  if (_coVersion != _colorOrderMap.version() || _coRanges.empty()) compileColorOrder();
+  unsigned r = _coLast;
+  if (pix >= _coRanges[r].end || (r > 0 && pix < _coRanges[r-1].end)) {
+    const unsigned last = _coRanges.size() - 1;
+    for (r = 0; r < last && pix >= _coRanges[r].end; r++);
+    _coLast = r;
+  }
+  return _coRanges[r].colorOrder;
+}
+
+
 BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count, bc.reversed, (bc.refreshReq || bc.type == TYPE_TM1814))
 , _skip(bc.skipAmount) //sacrificial pixels
@@ -128,6 +179,14 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 , _milliAmpsPerLed(bc.milliAmpsPerLed)
 , _milliAmpsMax(bc.milliAmpsMax)
 , _colorOrderMap(com)
+, _buffered(bc.doubleBuffer)
+, _pixels(nullptr)
+, _ablBri(255)
+, _ablScale(255)
+, _milliAmpsTotal(0)
+, _ablLast(0)
+, _coVersion(com.version())
+, _coLast(0)
 {
   if (!isDigital(bc.type) || !bc.count) return;
   if (!PinManager::allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
@@ -146,8 +205,7 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
   _hasRgb = hasRGB(bc.type);
   _hasWhite = hasWhite(bc.type);
   _hasCCT = hasCCT(bc.type);
-  if (bc.doubleBuffer && !allocateData(bc.count * Bus::getNumberOfChannels(bc.type))) return;
-  //_buffering = bc.doubleBuffer;
+  // buffer is a view into BusManager's frame buffer assigned after the bus is added
   uint16_t lenToCreate = bc.count;
   if (bc.type == TYPE_WS2812_1CH_X3) lenToCreate = NUM_ICS_WS2812_1CH_3X(bc.count); // only needs a third of "RGB" LEDs for NeoPixelBus
   _busPtr = PolyBus::create(_iType, _pins, lenToCreate + _skip, nr);
@@ -172,36 +230,62 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 //Stay safe with high amperage and have a reasonable safety margin!
 //I am NOT to be held liable for burned down garages or houses!
 
-// To disable brightness limiter we either set output max current to 0 or single LED current to 0
-uint8_t BusDigital::estimateCurrentAndLimitBri() {
-  bool useWackyWS2815PowerModel = false;
-  byte actualMilliampsPerLed = _milliAmpsPerLed;
-
-  if (_milliAmpsMax < MA_FOR_ESP/BusManager::getNumBusses() || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
-    return _bri;
-  }
+// brightness scale (255 = not limited) that keeps current within budget
+// with smoothing, rising load is anticipated from the last frame and brightness recovers gradually to avoid pumping
+static uint8_t ablScale(uint32_t current, uint32_t budget, uint32_t &last, uint8_t &scale, bool smooth) {
+  uint32_t expected = current;
+  if (smooth && current > last) expected += current - last;
+  last = current;
+  unsigned target = expected > budget ? (budget * 255) / expected : 255;
+  if (!smooth || target < scale) scale = target;
+  else scale += (target - scale + 7) / 8;
+  return scale;
+}
 
-  if (_milliAmpsPerLed == 255) {
-    useWackyWS2815PowerModel = true;
-    actualMilliampsPerLed = 12; // from testing an actual strip
-  }
+uint32_t IRAM_ATTR BusDigital::loadPixel(unsigned pix) const {
+  const uint8_t *p = _pixels + pix * getNumberOfChannels();
+  if (!hasRGB()) return RGBW32(0, 0, 0, p[0]);
+  return RGBW32(p[0], p[1], p[2], hasWhite() ? p[3] : 0);
+}
 
-  size_t powerBudget = (_milliAmpsMax - MA_FOR_ESP/BusManager::getNumBusses()); //80/120mA for ESP power
-  if (powerBudget > getLength()) { //each LED uses about 1mA in standby, exclude that from power budget
-    powerBudget -= getLength();
-  } else {
-    powerBudget = 0;
-  }
+// estimates current drawn by pixels at bus brightness (excluding standby current), 0 if LED current is not set
+uint32_t BusDigital::estimateCurrent() const {
+  if (!_valid || _milliAmpsPerLed == 0) return 0;
+  const bool useWackyWS2815PowerModel = _milliAmpsPerLed == 255;
+  const unsigned actualMilliampsPerLed = useWackyWS2815PowerModel ? 12 : _milliAmpsPerLed; // from testing an actual strip
 
   uint32_t busPowerSum = 0;
-  for (unsigned i = 0; i < getLength(); i++) {  //sum up the usage of each LED
-    uint32_t c = getPixelColor(i); // always returns original or restored color without brightness scaling
-    byte r = R(c), g = G(c), b = B(c), w = W(c);
-
-    if (useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-      busPowerSum += (max(max(r,g),b)) * 3;
+  if (_pixels && !useWackyWS2815PowerModel) {
+    const unsigned stride = getNumberOfChannels();
+    if (!hasCCT()) {
+      // slice holds color channels only: sum 4 bytes at a time in two 16 bit lanes (128 words cannot overflow a lane)
+      const unsigned size = _len * stride;
+      unsigned i = 0;
+      while (i + 4 <= size) {
+        uint32_t acc = 0;
+        const unsigned end = min(size & ~3U, i + 4*128);
+        for (; i < end; i += 4) {
+          uint32_t w;
+          memcpy(&w, _pixels + i, sizeof(w)); // slices are not word aligned
+          acc += (w & 0x00FF00FF) + ((w >> 8) & 0x00FF00FF);
+        }
+        busPowerSum += (acc & 0xFFFF) + (acc >> 16);
+      }
+      for (; i < size; i++) busPowerSum += _pixels[i];
     } else {
-      busPowerSum += (r + g + b + w);
+      const uint8_t *p = _pixels;
+      for (unsigned i = 0; i < _len; i++, p += stride) for (unsigned c = 0; c < stride - 1; c++) busPowerSum += p[c]; // skip CCT byte
+    }
+    if (!hasRGB()) busPowerSum *= 4; // white only pixels count as (w,w,w,w) like getPixelColor() returns them
+  } else {
+    for (unsigned i = 0; i < _len; i++) {  //sum up the usage of each LED
+      uint32_t c = getPixelColor(i); // always returns original or restored color without brightness scaling
+      byte r = R(c), g = G(c), b = B(c), w = W(c);
+      if (useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
+        busPowerSum += (max(max(r,g),b)) * 3;
+      } else {
+        busPowerSum += (r + g + b + w);
+      }
     }
   }
 
@@ -211,61 +295,80 @@ uint8_t BusDigital::estimateCurrentAndLimitBri() {
   }
 
   // powerSum has all the values of channels summed (max would be getLength()*765 as white is excluded) so convert to milliAmps
-  busPowerSum = (busPowerSum * actualMilliampsPerLed) / 765;
-  _milliAmpsTotal = busPowerSum * _bri / 255;
+  return (uint64_t(busPowerSum) * actualMilliampsPerLed * _bri) / (765 * 255);
+}
 
-  uint8_t newBri = _bri;
-  if (busPowerSum * _bri / 255 > powerBudget) { //scale brightness down to stay in current limit
-    float scale = (float)(powerBudget * 255) / (float)(busPowerSum * _bri);
-    if (scale >= 1.0f) return _bri;
-    _milliAmpsTotal = ceilf((float)_milliAmpsTotal * scale);
-    uint8_t scaleB = min((int)(scale * 255), 255);
-    newBri = unsigned(_bri * scaleB) / 256 + 1;
+// per output limiter (used if there is no global current limit), current as returned by estimateCurrent()
+// To disable brightness limiter we either set output max current to 0 or single LED current to 0
+void BusDigital::limitCurrent(uint32_t current, bool smooth) {
+  uint8_t scale = 255;
+  if (_milliAmpsPerLed && _milliAmpsMax >= MA_FOR_ESP/BusManager::getNumBusses()) { //0 mA per LED and too low numbers turn off calculation
+    uint32_t powerBudget = _milliAmpsMax - MA_FOR_ESP/BusManager::getNumBusses(); //80/120mA for ESP power
+    powerBudget = powerBudget > getLength() ? powerBudget - getLength() : 0; //each LED uses about 1mA in standby, exclude that from power budget
+    scale = ablScale(current, powerBudget, _ablLast, _ablScale, smooth);
   }
-  return newBri;
+  setCurrentLimit(scale, current);
+}
+
+// sets brightness used by next show() from limiter's scale
+void BusDigital::setCurrentLimit(uint8_t scale, uint32_t current) {
+  if (scale < 255) {
+    _ablBri = unsigned(_bri * scale) / 256 + 1;
+    current = (current * scale + 254) / 255;
+  } else _ablBri = _bri;
+  _milliAmpsTotal = min(current, (uint32_t)UINT16_MAX);
 }
 
 void BusDigital::show() {
-  _milliAmpsTotal = 0;
   if (!_valid) return;
 
   uint8_t cctWW = 0, cctCW = 0;
-  unsigned newBri = estimateCurrentAndLimitBri();  // will fill _milliAmpsTotal
+  unsigned newBri = min(_ablBri, _bri);  // set by BusManager's current limiter
   if (newBri < _bri) PolyBus::setBrightness(_busPtr, _iType, newBri); // limit brightness to stay within current limits
 
-  if (_data) {
-    size_t channels = getNumberOfChannels();
+  if (_pixels) {
     int16_t oldCCT = Bus::_cct; // temporarily save bus CCT
-    for (size_t i=0; i<_len; i++) {
-      size_t offset = i * channels;
-      unsigned co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
-      uint32_t c;
-      if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
-        switch (i%3) {
-          case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
-          case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
-          case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
-        }
-      } else {
-        if (hasRGB()) c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], hasWhite() ? _data[offset+3] : 0);
-        else          c = RGBW32(0, 0, 0, _data[offset]);
+    if (_coVersion != _colorOrderMap.version() || _coRanges.empty()) compileColorOrder();
+    const bool plain = !_reversed && !hasCCT() && _type != TYPE_WS2812_1CH_X3;
+    const unsigned stride = getNumberOfChannels();
+    unsigned i = 0;
+    for (const corange_t &range : _coRanges) {
+      // color order is resolved once for each run of pixels with the same order
+      const unsigned co  = range.colorOrder;
+      const unsigned end = min((unsigned)_len, (unsigned)range.end);
+      if (plain) {
+        const uint8_t *p = _pixels + i * stride;
+        if (stride == 3)      for (; i < end; i++, p += 3) PolyBus::setPixelColor(_busPtr, _iType, i + _skip, RGBW32(p[0], p[1], p[2], 0), co);
+        else if (stride == 4) for (; i < end; i++, p += 4) PolyBus::setPixelColor(_busPtr, _iType, i + _skip, RGBW32(p[0], p[1], p[2], p[3]), co);
+        else                  for (; i < end; i++)         PolyBus::setPixelColor(_busPtr, _iType, i + _skip, loadPixel(i), co);
+        continue;
       }
-      if (hasCCT()) {
-        // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
-        // we need to extract and appy CCT value for each pixel individually even though all buses share the same _cct variable
-        // TODO: there is an issue if CCT is calculated from RGB value (_cct==-1), we cannot do that with double buffer
-        Bus::_cct = _data[offset+channels-1];
-        Bus::calculateCCT(c, cctWW, cctCW);
+      for (; i < end; i++) {
+        uint32_t c = loadPixel(i);
+        if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3), slice holds W only
+          switch (i%3) {
+            case 0: c = RGBW32(_pixels[i]  , _pixels[i+1], _pixels[i+2], 0); break;
+            case 1: c = RGBW32(_pixels[i-1], _pixels[i]  , _pixels[i+1], 0); break;
+            case 2: c = RGBW32(_pixels[i-2], _pixels[i-1], _pixels[i]  , 0); break;
+          }
+        }
+        if (hasCCT()) {
+          // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
+          // we need to extract and appy CCT value for each pixel individually even though all buses share the same _cct variable
+          // TODO: there is an issue if CCT is calculated from RGB value (_cct==-1), we cannot do that with double buffer
+          Bus::_cct = _pixels[i * stride + stride - 1];
+          Bus::calculateCCT(c, cctWW, cctCW);
+        }
+        unsigned pix = i;
+        if (_reversed) pix = _len - pix -1;
+        pix += _skip;
+        PolyBus::setPixelColor(_busPtr, _iType, pix, c, co, (cctCW<<8) | cctWW);
       }
-      unsigned pix = i;
-      if (_reversed) pix = _len - pix -1;
-      pix += _skip;
-      PolyBus::setPixelColor(_busPtr, _iType, pix, c, co, (cctCW<<8) | cctWW);
     }
     #if !defined(STATUSLED) || STATUSLED>=0
-    if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
+    if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, colorOrderAt(0)); // paint skipped pixels black
     #endif
-    for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
+    for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, colorOrderAt(0)); // paint skipped pixels black
     Bus::_cct = oldCCT;
   } else {
     if (newBri < _bri) {
@@ -279,7 +382,7 @@ void BusDigital::show() {
       }
     }
   }
-  PolyBus::show(_busPtr, _iType, !_data); // faster if buffer consistency is not important (use !_buffering this causes 20% FPS drop)
+  PolyBus::show(_busPtr, _iType, !_pixels); // faster if buffer consistency is not important (use !_buffering this causes 20% FPS drop)
   // restore bus brightness to its original value
   // this is done right after show, so this is only OK if LED updates are completed before show() returns
   // or async show has a separate buffer (ESP32 RMT and I2S are ok)
@@ -301,7 +404,7 @@ void BusDigital::setBrightness(uint8_t b) {
 //TODO only show if no new show due in the next 50ms
 void BusDigital::setStatusPixel(uint32_t c) {
   if (_valid && _skip) {
-    PolyBus::setPixelColor(_busPtr, _iType, 0, c, _colorOrderMap.getPixelColorOrder(_start, _colorOrder));
+    PolyBus::setPixelColor(_busPtr, _iType, 0, c, colorOrderAt(0));
     if (canShow()) PolyBus::show(_busPtr, _iType);
   }
 }
@@ -311,21 +414,22 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   uint8_t cctWW = 0, cctCW = 0;
   if (hasWhite()) c = autoWhiteCalc(c);
   if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
-  if (_data) {
-    size_t offset = pix * getNumberOfChannels();
+  if (_pixels) {
+    // store only channels the bus has
+    uint8_t *p = _pixels + pix * getNumberOfChannels();
     if (hasRGB()) {
-      _data[offset++] = R(c);
-      _data[offset++] = G(c);
-      _data[offset++] = B(c);
+      *p++ = R(c);
+      *p++ = G(c);
+      *p++ = B(c);
     }
-    if (hasWhite()) _data[offset++] = W(c);
+    if (hasWhite()) *p++ = W(c);
     // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
     // we need to store CCT value for each pixel (if there is a color correction in play, convert K in CCT ratio)
-    if (hasCCT())   _data[offset]   = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
+    if (hasCCT()) *p = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
   } else {
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
-    unsigned co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
+    unsigned co = colorOrderAt(pix);
     if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
       unsigned pOld = pix;
       pix = IC_INDEX_WS2812_1CH_3X(pix);
@@ -341,17 +445,33 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   }
 }
 
+// realtime direct output: colors are stored as received (no auto white, no white balance)
+// buffered RGB(W) buses copy the span into the frame buffer (CCT is kept), unbuffered CCT and single channel buses need per pixel processing
+void IRAM_ATTR BusDigital::setPixelsRaw(uint16_t pix, uint16_t count, const uint32_t *c) {
+  if (!_valid) return;
+  if (!hasRGB() || (!_pixels && (hasCCT() || _type == TYPE_WS2812_1CH_X3))) {
+    Bus::setPixelsRaw(pix, count, c);
+    return;
+  }
+  if (_pixels) {
+    const unsigned stride = getNumberOfChannels();
+    uint8_t *p = _pixels + pix * stride;
+    if (hasWhite()) for (unsigned i = 0; i < count; i++, p += stride) { p[0] = R(c[i]); p[1] = G(c[i]); p[2] = B(c[i]); p[3] = W(c[i]); }
+    else            for (unsigned i = 0; i < count; i++, p += stride) { p[0] = R(c[i]); p[1] = G(c[i]); p[2] = B(c[i]); }
+  } else {
+    for (unsigned i = 0; i < count; i++) {
+      unsigned p = (_reversed ? _len - (pix + i) - 1 : pix + i) + _skip;
+      PolyBus::setPixelColor(_busPtr, _iType, p, c[i], colorOrderAt(p));
+    }
+  }
+}
+
 // returns original color if global buffering is enabled, else returns lossly restored color from bus
 uint32_t IRAM_ATTR BusDigital::getPixelColor(uint16_t pix) const {
   if (!_valid) return 0;
-  if (_data) {
-    size_t offset = pix * getNumberOfChannels();
-    uint32_t c;
-    if (!hasRGB()) {
-      c = RGBW32(_data[offset], _data[offset], _data[offset], _data[offset]);
-    } else {
-      c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], hasWhite() ? _data[offset+3] : 0);
-    }
+  if (_pixels) {
+    uint32_t c = loadPixel(pix);
+    if (!hasRGB()) c = RGBW32(W(c), W(c), W(c), W(c));
     return c;
   } else {
     if (_reversed) pix = _len - pix -1;
@@ -382,6 +502,7 @@ void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
   _colorOrder = colorOrder;
+  _coRanges.clear(); // recompile on next use
 }
 
 // credit @willmmiles & @netmindz https://github.com/Aircoookie/WLED/pull/4056
@@ -421,6 +542,7 @@ void BusDigital::cleanup() {
   _iType = I_NONE;
   _valid = false;
   _busPtr = nullptr;
+  _pixels = nullptr; // frame buffer is owned by BusManager
   if (_data != nullptr) freeData();
   PinManager::deallocatePin(_pins[1], PinOwner::BusDigital);
   PinManager::deallocatePin(_pins[0], PinOwner::BusDigital);
@@ -710,6 +832,14 @@ std::vector<LEDType> BusOnOff::getLEDTypes() {
 BusNetwork::BusNetwork(BusConfig &bc)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count)
 , _broadcastLock(false)
+, _changed(true)
+, _pending(false)
+, _frameBri(0)
+, _maxFps(bc.frequency > 255 ? 255 : bc.frequency)
+, _lastSend(0)
+, _numFollowers(0)
+, _leader(nullptr)
+, _stats{}
 {
   switch (bc.type) {
     case TYPE_NET_ARTNET_RGB:
@@ -735,27 +865,84 @@ BusNetwork::BusNetwork(BusConfig &bc)
 }
 
 void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
-  if (!_valid || pix >= _len) return;
+  if (!_valid || pix >= _len || _leader) return; // leader has the data
   if (_hasWhite) c = autoWhiteCalc(c);
   if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
   unsigned offset = pix * _UDPchannels;
+  if (_data[offset] == R(c) && _data[offset+1] == G(c) && _data[offset+2] == B(c) && (!_hasWhite || _data[offset+3] == W(c))) return;
+  _changed = true; // frame needs to be sent
   _data[offset]   = R(c);
   _data[offset+1] = G(c);
   _data[offset+2] = B(c);
   if (_hasWhite) _data[offset+3] = W(c);
 }
 
+void BusNetwork::setPixelsRaw(uint16_t pix, uint16_t count, const uint32_t *c) {
+  if (!_valid || pix >= _len || _leader) return;
+  if (count > _len - pix) count = _len - pix;
+  uint8_t *d = _data + pix * _UDPchannels;
+  for (unsigned i = 0; i < count; i++, d += _UDPchannels) {
+    const uint32_t col = c[i];
+    if (d[0] == R(col) && d[1] == G(col) && d[2] == B(col) && (!_hasWhite || d[3] == W(col))) continue;
+    _changed = true;
+    d[0] = R(col);
+    d[1] = G(col);
+    d[2] = B(col);
+    if (_hasWhite) d[3] = W(col);
+  }
+}
+
 uint32_t BusNetwork::getPixelColor(uint16_t pix) const {
   if (!_valid || pix >= _len) return 0;
+  if (_leader) return _leader->getPixelColor(pix);
   unsigned offset = pix * _UDPchannels;
   return RGBW32(_data[offset], _data[offset+1], _data[offset+2], (hasWhite() ? _data[offset+3] : 0));
 }
 
 void BusNetwork::show() {
-  if (!_valid || !canShow()) return;
+  if (!_valid || !canShow() || _leader) return; // followers are sent by leader
+  if (_changed || _bri != _frameBri) {
+    _changed  = false;
+    _frameBri = _bri;
+    _pending  = true;
+    for (unsigned i = 0; i < _numFollowers; i++) _followers[i]->_pending = true;
+  }
+  // only receivers that miss the current frame (or need a keep-alive) get a packet
+  uint32_t    now = millis();
+  BusNetwork *receivers[NET_BUS_MAX_FANOUT];
+  IPAddress   clients[NET_BUS_MAX_FANOUT];
+  netstats_t *stats[NET_BUS_MAX_FANOUT];
+  unsigned    n = 0;
+  for (unsigned i = 0; i <= _numFollowers; i++) {
+    BusNetwork *bus = i ? _followers[i-1] : this;
+    if (!bus->isDue(now)) { bus->_stats.skipped++; continue; }
+    receivers[n] = bus;
+    clients[n]   = bus->_client;
+    stats[n++]   = &bus->_stats;
+  }
+  if (!n) return;
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, hasWhite());
+  realtimeBroadcast(_UDPtype, clients, stats, n, _len, _data, _bri, hasWhite());
   _broadcastLock = false;
+  for (unsigned i = 0; i < n; i++) {
+    receivers[i]->_pending  = false;
+    receivers[i]->_lastSend = now;
+  }
+}
+
+bool BusNetwork::isDue(uint32_t now) const {
+  uint32_t elapsed = now - _lastSend;
+  if (_keepAlive && elapsed >= _keepAlive) return true; // resend so receiver does not time out
+  return (_pending || !_keepAlive) && (!_maxFps || elapsed >= 1000U / _maxFps);
+}
+
+bool BusNetwork::follow(BusNetwork *leader) {
+  if (!_valid || !leader || leader == this || leader->_leader || leader->_numFollowers >= NET_BUS_MAX_FANOUT-1) return false;
+  if (leader->_type != _type || leader->_start != _start || leader->getLength() != getLength() || leader->_autoWhiteMode != _autoWhiteMode) return false;
+  leader->_followers[leader->_numFollowers++] = this;
+  _leader = leader;
+  freeData(); // pixels are taken from leader
+  return true;
 }
 
 uint8_t BusNetwork::getPins(uint8_t* pinArray) const {
@@ -802,7 +989,8 @@ uint32_t BusManager::memUsage(BusConfig &bc) {
       multiplier = PolyBus::isParallelI2S1Output() ? 24 : 2;
     #endif
   }
-  return (len * multiplier + bc.doubleBuffer * (bc.count + bc.skipAmount)) * channels;
+  // double buffering keeps channels (and CCT byte) of each pixel in BusManager's frame buffer
+  return len * multiplier * channels + (bc.doubleBuffer && Bus::isDigital(bc.type)) * bc.count * channels;
 }
 
 uint32_t BusManager::memUsage(unsigned maxChannels, unsigned maxCount, unsigned minBuses) {
@@ -814,7 +1002,10 @@ uint32_t BusManager::memUsage(unsigned maxChannels, unsigned maxCount, unsigned
 int BusManager::add(BusConfig &bc) {
   if (getNumBusses() - getNumVirtualBusses() >= WLED_MAX_BUSSES) return -1;
   if (Bus::isVirtual(bc.type)) {
-    busses[numBusses] = new BusNetwork(bc);
+    BusNetwork *bus = new BusNetwork(bc);
+    // bus with the same pixels as an existing one is sent by it (fan-out) instead of rendering & building packets twice
+    for (unsigned i = 0; i < numBusses; i++) if (busses[i]->isVirtual() && bus->follow(static_cast<BusNetwork*>(busses[i]))) break;
+    busses[numBusses] = bus;
   } else if (Bus::isDigital(bc.type)) {
     busses[numBusses] = new BusDigital(bc, numBusses, colorOrderMap);
   } else if (Bus::isOnOff(bc.type)) {
@@ -822,7 +1013,87 @@ int BusManager::add(BusConfig &bc) {
   } else {
     busses[numBusses] = new BusPwm(bc);
   }
-  return numBusses++;
+  numBusses++;
+  buildRanges();
+  return numBusses - 1;
+}
+
+// allocates frame buffer for all buffered digital buses and assigns each bus its slice
+// each slice keeps only the channels (and CCT) of its bus and slices are packed (no gaps between buses),
+// so the size matches the sum of memUsage() of buffered buses; if allocation fails buses write directly to NeoPixelBus
+// called once after all buses have been added (WS2812FX::finalizeInit()) and by removeAll()
+void BusManager::allocateFrameBuffer() {
+  if (_frameBuffer) free(_frameBuffer);
+  _frameBuffer = nullptr;
+  _frameLen = 0;
+  unsigned len = 0, size = 0;
+  for (unsigned i = 0; i < numBusses; i++) {
+    if (!busses[i]->isDigital() || !static_cast<BusDigital*>(busses[i])->isBuffered()) continue;
+    len  += busses[i]->getLength();
+    size += busses[i]->getLength() * busses[i]->getNumberOfChannels();
+  }
+  if (size) {
+    _frameBuffer = static_cast<uint8_t*>(calloc(size, sizeof(uint8_t)));
+    if (_frameBuffer) _frameLen = len;
+    DEBUG_PRINTF_P(PSTR("Frame buffer: %u pixels (%u bytes) %s.\n"), len, size, _frameBuffer ? "allocated" : "NOT allocated");
+  }
+  uint8_t *pixels = _frameBuffer;
+  for (unsigned i = 0; i < numBusses; i++) {
+    if (!busses[i]->isDigital()) continue;
+    BusDigital *bus = static_cast<BusDigital*>(busses[i]);
+    if (!_frameBuffer || !bus->isBuffered() || !bus->getLength()) { bus->setFrameBuffer(nullptr); continue; }
+    bus->setFrameBuffer(pixels);
+    pixels += bus->getLength() * bus->getNumberOfChannels();
+  }
+}
+
+// splits strip into ranges at every bus start & end so that each pixel lookup is a (binary) search instead of a scan of all buses
+void BusManager::buildRanges() {
+  uint16_t bounds[2*(WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES)];
+  unsigned n = 0;
+  for (unsigned i = 0; i < numBusses; i++) {
+    if (busses[i]->getLength() == 0) continue;
+    uint16_t b[2] = {busses[i]->getStart(), uint16_t(min(unsigned(busses[i]->getStart()) + busses[i]->getLength(), (unsigned)UINT16_MAX))};
+    for (unsigned j = 0; j < 2; j++) { // insert sorted, skip duplicates
+      unsigned k = 0;
+      while (k < n && bounds[k] < b[j]) k++;
+      if (k < n && bounds[k] == b[j]) continue;
+      for (unsigned m = n; m > k; m--) bounds[m] = bounds[m-1];
+      bounds[k] = b[j];
+      n++;
+    }
+  }
+  _numRanges = 0;
+  _lastRange = 0;
+  for (unsigned k = 1; k < n; k++) {
+    uint32_t mask = 0;
+    for (unsigned i = 0; i < numBusses; i++) {
+      unsigned bstart = busses[i]->getStart();
+      unsigned blen   = busses[i]->getLength();
+      if (blen && bstart <= bounds[k-1] && bstart + blen >= bounds[k]) mask |= 1UL << i;
+    }
+    if (!mask) continue; // gap
+    if (_numRanges && _ranges[_numRanges-1].end == bounds[k-1] && _ranges[_numRanges-1].buses == mask) {
+      _ranges[_numRanges-1].end = bounds[k]; // same buses, merge with previous range
+    } else {
+      _ranges[_numRanges++] = {bounds[k-1], bounds[k], mask};
+    }
+  }
+}
+
+const BusManager::busrange_t* IRAM_ATTR BusManager::findRange(uint16_t pix) {
+  if (_lastRange < _numRanges && pix >= _ranges[_lastRange].start && pix < _ranges[_lastRange].end) return &_ranges[_lastRange];
+  unsigned lo = 0, hi = _numRanges;
+  while (lo < hi) {
+    unsigned mid = (lo + hi) / 2;
+    if      (pix <  _ranges[mid].start) hi = mid;
+    else if (pix >= _ranges[mid].end)   lo = mid + 1;
+    else {
+      _lastRange = mid;
+      return &_ranges[mid];
+    }
+  }
+  return nullptr;
 }
 
 // credit @willmmiles
@@ -862,6 +1133,8 @@ void BusManager::removeAll() {
   while (!canAllShow()) yield();
   for (unsigned i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
+  buildRanges();
+  allocateFrameBuffer(); // frees frame buffer
   _parallelOutputs = 1;
   PolyBus::setParallelI2S1Output(false);
 }
@@ -937,13 +1210,46 @@ void BusManager::off() {
   #endif
 }
 
+// estimates current of all digital buses and sets brightness each of them may use in next show()
+// with global limit all buses share one budget, otherwise each bus is limited by its own maximum current
+void BusManager::limitCurrent() {
+  uint32_t current[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
+  uint32_t total = 0;
+  unsigned leds = 0;
+  for (unsigned i = 0; i < numBusses; i++) {
+    current[i] = 0;
+    if (!busses[i]->isDigital()) continue;
+    BusDigital *bus = static_cast<BusDigital*>(busses[i]);
+    current[i] = bus->estimateCurrent();
+    if (!_milliAmpsMax) { bus->limitCurrent(current[i], _ablSmoothing); continue; }
+    total += current[i];
+    if (bus->getLEDCurrent()) leds += bus->getLength(); // each LED uses about 1mA in standby, exclude that from power budget
+  }
+  if (!_milliAmpsMax) return;
+  uint32_t budget = _milliAmpsMax > MA_FOR_ESP + leds ? _milliAmpsMax - MA_FOR_ESP - leds : 0;
+  uint8_t scale = ablScale(total, budget, _ablLast, _ablScale, _ablSmoothing);
+  for (unsigned i = 0; i < numBusses; i++) {
+    if (!busses[i]->isDigital()) continue;
+    BusDigital *bus = static_cast<BusDigital*>(busses[i]);
+    bus->setCurrentLimit(bus->getLEDCurrent() ? scale : 255, current[i]);
+  }
+}
+
 void BusManager::show() {
+  uint32_t perfShow = PerfCounters::start();
   _milliAmpsUsed = 0;
+  uint32_t perfABL = PerfCounters::start();
+  limitCurrent();
+  PerfCounters::accumulate(PERF_ABL, perfABL);
   for (unsigned i = 0; i < numBusses; i++) {
+    uint32_t perfBus = PerfCounters::start();
     busses[i]->show();
+    PerfCounters::record(PERF_BUS + i, perfBus);
     _milliAmpsUsed += busses[i]->getUsedCurrent();
   }
   if (_milliAmpsUsed) _milliAmpsUsed += MA_FOR_ESP;
+  PerfCounters::commit(PERF_ABL);
+  PerfCounters::record(PERF_SHOW, perfShow);
 }
 
 void BusManager::setStatusPixel(uint32_t c) {
@@ -953,10 +1259,32 @@ void BusManager::setStatusPixel(uint32_t c) {
 }
 
 void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c) {
-  for (unsigned i = 0; i < numBusses; i++) {
-    unsigned bstart = busses[i]->getStart();
-    if (pix < bstart || pix >= bstart + busses[i]->getLength()) continue;
-    busses[i]->setPixelColor(pix - bstart, c);
+  const busrange_t *r = findRange(pix);
+  if (!r) return;
+  for (uint32_t mask = r->buses; mask; mask &= mask - 1) {
+    Bus *bus = busses[__builtin_ctz(mask)];
+    bus->setPixelColor(pix - bus->getStart(), c);
+  }
+}
+
+void IRAM_ATTR BusManager::setPixels(uint16_t start, uint16_t count, const uint32_t *c, bool raw) {
+  const unsigned end = start + count;
+  unsigned pix = start;
+  while (pix < end) {
+    const busrange_t *r = findRange(pix);
+    if (!r) { // skip gap up to next range
+      unsigned next = end;
+      for (unsigned k = 0; k < _numRanges; k++) if (_ranges[k].start > pix) { next = _ranges[k].start; break; }
+      pix = next;
+      continue;
+    }
+    const unsigned n = min(end, (unsigned)r->end) - pix;
+    for (uint32_t mask = r->buses; mask; mask &= mask - 1) {
+      Bus *bus = busses[__builtin_ctz(mask)];
+      if (raw) bus->setPixelsRaw(pix - bus->getStart(), n, c + (pix - start));
+      else     bus->setPixels(pix - bus->getStart(), n, c + (pix - start));
+    }
+    pix += n;
   }
 }
 
@@ -976,12 +1304,10 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
 }
 
 uint32_t BusManager::getPixelColor(uint16_t pix) {
-  for (unsigned i = 0; i < numBusses; i++) {
-    unsigned bstart = busses[i]->getStart();
-    if (!busses[i]->containsPixel(pix)) continue;
-    return busses[i]->getPixelColor(pix - bstart);
-  }
-  return 0;
+  const busrange_t *r = findRange(pix);
+  if (!r) return 0;
+  Bus *bus = busses[__builtin_ctz(r->buses)]; // first bus containing pixel
+  return bus->getPixelColor(pix - bus->getStart());
 }
 
 bool BusManager::canAllShow() {
@@ -996,6 +1322,12 @@ Bus* BusManager::getBus(uint8_t busNr) {
   return busses[busNr];
 }
 
+Bus* BusManager::getBusForRange(uint16_t first, uint16_t last) {
+  const busrange_t *r = findRange(first);
+  if (!r || last >= r->end || (r->buses & (r->buses - 1))) return nullptr; // range continues into other buses or buses overlap
+  return busses[__builtin_ctz(r->buses)];
+}
+
 //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
 uint16_t BusManager::getTotalLength() {
   unsigned len = 0;
@@ -1008,9 +1340,12 @@ bool PolyBus::useParallelI2S = false;
 // Bus static member definition
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
+uint8_t Bus::_cctTableBlend = 255; // table not built yet
+uint16_t Bus::_cctTable[256];
 uint8_t Bus::_gAWM = 255;
 
-uint16_t BusDigital::_milliAmpsTotal = 0;
+uint16_t BusNetwork::_keepAlive = 1000;
+
 
 uint8_t       BusManager::numBusses = 0;
 Bus*          BusManager::busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
@@ -1018,3 +1353,11 @@ ColorOrderMap BusManager::colorOrderMap = {};
 uint16_t      BusManager::_milliAmpsUsed = 0;
 uint16_t      BusManager::_milliAmpsMax = ABL_MILLIAMPS_DEFAULT;
 uint8_t       BusManager::_parallelOutputs = 1;
+BusManager::busrange_t BusManager::_ranges[2*(WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES)];
+uint8_t       BusManager::_numRanges = 0;
+uint8_t       BusManager::_lastRange = 0;
+bool          BusManager::_ablSmoothing = false;
+uint8_t       BusManager::_ablScale = 255;
+uint32_t      BusManager::_ablLast = 0;
+uint8_t*      BusManager::_frameBuffer = nullptr;
+uint16_t      BusManager::_frameLen = 0;
@@ -35,11 +35,13 @@ struct ColorOrderMap {
     bool add(uint16_t start, uint16_t len, uint8_t colorOrder);
 
     inline uint8_t count() const { return _mappings.size(); }
+    inline uint8_t version() const { return _version; } // changes whenever mappings change
     inline void reserve(size_t num) { _mappings.reserve(num); }
 
     void reset() {
       _mappings.clear();
       _mappings.shrink_to_fit();
+      _version++;
     }
 
     const ColorOrderMapEntry* get(uint8_t n) const {
@@ -48,9 +50,11 @@ struct ColorOrderMap {
     }
 
     [[gnu::hot]] uint8_t getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder) const;
+    uint8_t getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder, uint16_t &runEnd) const; // also returns first pixel where order may change
 
   private:
     std::vector<ColorOrderMapEntry> _mappings;
+    uint8_t _version = 0;
 };
 
 
@@ -84,6 +88,8 @@ class Bus {
     virtual bool     canShow() const                          { return true; }
     virtual void     setStatusPixel(uint32_t c)                {}
     virtual void     setPixelColor(uint16_t pix, uint32_t c) = 0;
+    virtual void     setPixels(uint16_t pix, uint16_t count, const uint32_t *c) { for (unsigned i = 0; i < count; i++) setPixelColor(pix + i, c[i]); }
+    virtual void     setPixelsRaw(uint16_t pix, uint16_t count, const uint32_t *c) { setPixels(pix, count, c); } // without auto white & white balance (if bus supports it)
     virtual void     setBrightness(uint8_t b)                  { _bri = b; };
     virtual void     setColorOrder(uint8_t co)                 {}
     virtual uint32_t getPixelColor(uint16_t pix) const         { return 0; }
@@ -188,7 +194,11 @@ class Bus {
     //   63 - semi additive/nonlinear (CCT 127 => 66% warm, 66% cold)
     //  127 - additive CCT blending (CCT 127 => 100% warm, 100% cold)
     static uint8_t _cctBlend;
+    // WW (low byte) & CW (high byte) ratios for each relative CCT, built for _cctTableBlend
+    static uint8_t  _cctTableBlend;
+    static uint16_t _cctTable[256];
 
+    static void buildCCTTable();
     uint32_t autoWhiteCalc(uint32_t c) const;
     uint8_t *allocateData(size_t size = 1);
     void     freeData() { if (_data != nullptr) free(_data); _data = nullptr; }
@@ -205,6 +215,7 @@ class BusDigital : public Bus {
     void setBrightness(uint8_t b) override;
     void setStatusPixel(uint32_t c) override;
     [[gnu::hot]] void setPixelColor(uint16_t pix, uint32_t c) override;
+    [[gnu::hot]] void setPixelsRaw(uint16_t pix, uint16_t count, const uint32_t *c) override;
     void setColorOrder(uint8_t colorOrder) override;
     [[gnu::hot]] uint32_t getPixelColor(uint16_t pix) const override;
     uint8_t  getColorOrder() const override  { return _colorOrder; }
@@ -216,6 +227,11 @@ class BusDigital : public Bus {
     uint16_t getMaxCurrent() const override  { return _milliAmpsMax; }
     void begin() override;
     void cleanup();
+    inline bool isBuffered() const { return _buffered; }
+    inline void setFrameBuffer(uint8_t *pixels) { _pixels = pixels; } // set by BusManager
+    uint32_t estimateCurrent() const;
+    void     limitCurrent(uint32_t current, bool smooth);
+    void     setCurrentLimit(uint8_t scale, uint32_t current);
 
     static std::vector<LEDType> getLEDTypes();
 
@@ -229,8 +245,26 @@ class BusDigital : public Bus {
     uint16_t _milliAmpsMax;
     void * _busPtr;
     const ColorOrderMap &_colorOrderMap;
-
-    static uint16_t _milliAmpsTotal; // is overwitten/recalculated on each show()
+    bool       _buffered;   // double buffering requested
+    uint8_t   *_pixels;     // bus slice of BusManager's frame buffer (nullptr if not buffered), getNumberOfChannels() bytes per pixel:
+                            // R,G,B (if bus has RGB), W (if bus has white), CCT (if bus has CCT)
+    uint8_t    _ablBri;     // brightness allowed by current limiter (used in show())
+    uint8_t    _ablScale;   // per output limiter state
+    uint16_t   _milliAmpsTotal; // is overwitten/recalculated on each show()
+    uint32_t   _ablLast;
+
+    // color order of bus pixels compiled from ColorOrderMap: pixels below end (and above previous end) use colorOrder
+    typedef struct {
+      uint16_t end;
+      uint8_t  colorOrder;
+    } corange_t;
+    std::vector<corange_t> _coRanges;
+    uint8_t    _coVersion;  // ColorOrderMap version _coRanges were compiled from
+    uint8_t    _coLast;     // last range used
+
+    void compileColorOrder();
+    [[gnu::hot]] uint8_t colorOrderAt(unsigned pix);
+    [[gnu::hot]] uint32_t loadPixel(unsigned pix) const; // color of pixel in frame buffer slice (as stored)
 
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) const {
       if (restoreBri < 255) {
@@ -243,7 +277,6 @@ class BusDigital : public Bus {
       return c;
     }
 
-    uint8_t  estimateCurrentAndLimitBri();
 };
 
 
@@ -293,6 +326,20 @@ class BusOnOff : public Bus {
 };
 
 
+// max. number of receivers a network bus sends the same frame to (itself and buses following it)
+#ifndef NET_BUS_MAX_FANOUT
+  #define NET_BUS_MAX_FANOUT 8
+#endif
+
+// send statistics of a network bus destination
+typedef struct NetBusStats {
+  uint32_t packets;  // packets sent
+  uint32_t errors;   // packets that could not be sent
+  uint32_t bytes;    // bytes sent (including headers)
+  uint32_t sendTime; // time (us) spent sending last frame
+  uint32_t skipped;  // frames not sent (unchanged or above max fps)
+} netstats_t;
+
 class BusNetwork : public Bus {
   public:
     BusNetwork(BusConfig &bc);
@@ -300,18 +347,40 @@ class BusNetwork : public Bus {
 
     bool canShow() const override  { return !_broadcastLock; } // this should be a return value from UDP routine if it is still sending data out
     void setPixelColor(uint16_t pix, uint32_t c) override;
+    void setPixelsRaw(uint16_t pix, uint16_t count, const uint32_t *c) override;
     uint32_t getPixelColor(uint16_t pix) const override;
     uint8_t  getPins(uint8_t* pinArray = nullptr) const override;
     void show() override;
     void cleanup();
+    bool follow(BusNetwork *leader); // leader sends its frames to this bus' receiver too (same type & pixels)
+    uint16_t getFrequency() const override    { return _maxFps; } // max frames per second sent to receiver (0 = unlimited)
+
+    inline const netstats_t &getStats() const { return _stats; }
+    inline bool isFollower() const            { return _leader != nullptr; }
+
+    static inline void     setKeepAlive(uint16_t ms) { _keepAlive = ms; }
+    static inline uint16_t getKeepAlive()            { return _keepAlive; }
 
     static std::vector<LEDType> getLEDTypes();
 
   private:
-    IPAddress _client;
-    uint8_t   _UDPtype;
-    uint8_t   _UDPchannels;
-    bool      _broadcastLock;
+    IPAddress   _client;
+    uint8_t     _UDPtype;
+    uint8_t     _UDPchannels;
+    bool        _broadcastLock;
+    bool        _changed;                             // pixel data changed since last frame
+    bool        _pending;                             // receiver has not got the latest frame yet
+    uint8_t     _frameBri;                            // brightness of last frame
+    uint8_t     _maxFps;
+    uint32_t    _lastSend;                            // millis() of last packet sent to receiver
+    uint8_t     _numFollowers;
+    BusNetwork *_leader;                              // bus rendering & sending for this one (nullptr if none)
+    BusNetwork *_followers[NET_BUS_MAX_FANOUT-1];
+    netstats_t  _stats;
+
+    static uint16_t _keepAlive; // resend unchanged frames after this many ms (0 = send every frame)
+
+    bool isDue(uint32_t now) const;
 };
 
 
@@ -386,15 +455,21 @@ class BusManager {
     static bool canAllShow();
     static void setStatusPixel(uint32_t c);
     [[gnu::hot]] static void setPixelColor(uint16_t pix, uint32_t c);
+    [[gnu::hot]] static void setPixels(uint16_t start, uint16_t count, const uint32_t *c, bool raw = false); // span is split across buses once (raw skips color correction)
     static void setBrightness(uint8_t b);
     // for setSegmentCCT(), cct can only be in [-1,255] range; allowWBCorrection will convert it to K
     // WARNING: setSegmentCCT() is a misleading name!!! much better would be setGlobalCCT() or just setCCT()
     static void setSegmentCCT(int16_t cct, bool allowWBCorrection = false);
     static inline void setMilliampsMax(uint16_t max) { _milliAmpsMax = max;}
+    static inline void setABLSmoothing(bool en)      { _ablSmoothing = en; }
+    static inline bool getABLSmoothing()             { return _ablSmoothing; }
     static uint32_t getPixelColor(uint16_t pix);
     static inline int16_t getSegmentCCT() { return Bus::getCCT(); }
 
     static Bus* getBus(uint8_t busNr);
+    static void allocateFrameBuffer(); // (re)allocates frame buffer of buffered digital buses, call after all buses are added
+    static inline uint16_t getFrameBufferLength()  { return _frameLen; }
+    static Bus* getBusForRange(uint16_t first, uint16_t last); // returns bus if it is the only one containing pixels first to last
 
     //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
     static uint16_t getTotalLength();
@@ -411,6 +486,27 @@ class BusManager {
     static uint16_t _milliAmpsMax;
     static uint8_t _parallelOutputs;
 
+    // pixel ranges sorted by start, each mapped to buses that contain it (buses may overlap), gaps are omitted
+    typedef struct BusRange {
+      uint16_t start;
+      uint16_t end;   // exclusive
+      uint32_t buses; // bit mask of bus indexes
+    } busrange_t;
+    static busrange_t _ranges[2*(WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES)];
+    // frame buffer shared by all buffered digital buses (each bus gets its own slice)
+    static uint8_t   *_frameBuffer;
+    static uint16_t   _frameLen;  // buffered pixels
+    static uint8_t    _numRanges;
+    static uint8_t    _lastRange; // last range found (pixels are usually accessed in order)
+
+    static bool     _ablSmoothing; // anticipate rising load and let brightness recover slowly
+    static uint8_t  _ablScale;     // global limiter state
+    static uint32_t _ablLast;
+
+    static void buildRanges();
+    static void limitCurrent();
+    [[gnu::hot]] static const busrange_t *findRange(uint16_t pix);
+
     #ifdef ESP32_DATA_IDLE_HIGH
     static void    esp32RMTInvertIdle() ;
     #endif
@@ -110,6 +110,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   uint16_t total = hw_led[F("total")] | strip.getLengthTotal();
   uint16_t ablMilliampsMax = hw_led[F("maxpwr")] | BusManager::ablMilliampsMax();
   BusManager::setMilliampsMax(ablMilliampsMax);
+  BusManager::setABLSmoothing(hw_led[F("ablsm")] | BusManager::getABLSmoothing());
+  BusNetwork::setKeepAlive(hw_led[F("netka")] | BusNetwork::getKeepAlive());
   Bus::setGlobalAWMode(hw_led[F("rgbwm")] | AW_GLOBAL_DISABLED);
   CJSON(strip.correctWB, hw_led["cct"]);
   CJSON(strip.cctFromRgb, hw_led[F("cr")]);
@@ -117,6 +119,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(strip.cctBlending, hw_led[F("cb")]);
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
+  strip.setFrameBudget(hw_led[F("fb")] | strip.getFrameBudget());
   CJSON(useGlobalLedBuffer, hw_led[F("ld")]);
 
   #ifndef WLED_DISABLE_2D
@@ -387,7 +390,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   }
 
   CJSON(serialBaud, hw[F("baud")]);
-  if (serialBaud < 96 || serialBaud > 15000) serialBaud = 1152;
+  if (serialBaud < 96 || serialBaud > WLED_SERIAL_MAX_BAUD) serialBaud = 1152;
   updateBaudRate(serialBaud *100);
 
   JsonArray hw_if_i2c = hw[F("if")][F("i2c-pin")];
@@ -447,6 +450,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject light_tr = light["tr"];
   CJSON(fadeTransition, light_tr["mode"]);
   CJSON(modeBlending, light_tr["fx"]);
+  CJSON(blendingStyle, light_tr["bs"]);
+  if (blendingStyle >= BLEND_STYLE_COUNT) blendingStyle = BLEND_STYLE_FADE;
   int tdd = light_tr["dur"] | -1;
   if (tdd >= 0) transitionDelay = transitionDelayDefault = tdd * 100;
   strip.setTransition(fadeTransition ? transitionDelayDefault : 0);
@@ -506,6 +511,10 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(receiveDirect, if_live["en"]);  // UDP/Hyperion realtime
   CJSON(useMainSegmentOnly, if_live[F("mso")]);
   CJSON(realtimeRespectLedMaps, if_live[F("rlm")]);
+  CJSON(realtimePlayoutDepth, if_live[F("pbuf")]);
+  if (realtimePlayoutDepth > RT_PLAYOUT_MAX_DEPTH) realtimePlayoutDepth = RT_PLAYOUT_MAX_DEPTH;
+  CJSON(realtimeInterpolate, if_live[F("pint")]);
+  CJSON(realtimeDirect, if_live[F("direct")]);
   CJSON(e131Port, if_live["port"]); // 5568
   if (e131Port == DDP_DEFAULT_PORT) e131Port = E131_DEFAULT_PORT; // prevent double DDP port allocation
   CJSON(e131Multicast, if_live[F("mc")]);
@@ -513,6 +522,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_live_dmx = if_live["dmx"];
   CJSON(e131Universe, if_live_dmx[F("uni")]);
   CJSON(e131SkipOutOfSequence, if_live_dmx[F("seqskip")]);
+  CJSON(e131WaitForFrame, if_live_dmx[F("sync")]);
+  CJSON(e131FrameTimeout, if_live_dmx[F("synctmo")]);
   CJSON(DMXAddress, if_live_dmx[F("addr")]);
   if (!DMXAddress || DMXAddress > 510) DMXAddress = 1;
   CJSON(DMXSegmentSpacing, if_live_dmx[F("dss")]);
@@ -816,12 +827,15 @@ void serializeConfig() {
   JsonObject hw_led = hw.createNestedObject("led");
   hw_led[F("total")] = strip.getLengthTotal(); //provided for compatibility on downgrade and per-output ABL
   hw_led[F("maxpwr")] = BusManager::ablMilliampsMax();
+  hw_led[F("ablsm")] = BusManager::getABLSmoothing();
+  hw_led[F("netka")] = BusNetwork::getKeepAlive();
   hw_led[F("ledma")] = 0; // no longer used
   hw_led["cct"] = strip.correctWB;
   hw_led[F("cr")] = strip.cctFromRgb;
   hw_led[F("ic")] = cctICused;
   hw_led[F("cb")] = strip.cctBlending;
   hw_led["fps"] = strip.getTargetFps();
+  hw_led[F("fb")] = strip.getFrameBudget();
   hw_led[F("rgbwm")] = Bus::getGlobalAWMode(); // global auto white mode override
   hw_led[F("ld")] = useGlobalLedBuffer;
 
@@ -940,6 +954,7 @@ void serializeConfig() {
   JsonObject light_tr = light.createNestedObject("tr");
   light_tr["mode"] = fadeTransition;
   light_tr["fx"] = modeBlending;
+  light_tr["bs"] = blendingStyle;
   light_tr["dur"] = transitionDelayDefault / 100;
   light_tr["pal"] = strip.paletteFade;
   light_tr[F("rpc")] = randomPaletteChangeTime;
@@ -992,12 +1007,17 @@ void serializeConfig() {
   if_live["en"] = receiveDirect; // UDP/Hyperion realtime
   if_live[F("mso")] = useMainSegmentOnly;
   if_live[F("rlm")] = realtimeRespectLedMaps;
+  if_live[F("pbuf")] = realtimePlayoutDepth;
+  if_live[F("pint")] = realtimeInterpolate;
+  if_live[F("direct")] = realtimeDirect;
   if_live["port"] = e131Port;
   if_live[F("mc")] = e131Multicast;
 
   JsonObject if_live_dmx = if_live.createNestedObject("dmx");
   if_live_dmx[F("uni")] = e131Universe;
   if_live_dmx[F("seqskip")] = e131SkipOutOfSequence;
+  if_live_dmx[F("sync")] = e131WaitForFrame;
+  if_live_dmx[F("synctmo")] = e131FrameTimeout;
   if_live_dmx[F("e131prio")] = e131Priority;
   if_live_dmx[F("addr")] = DMXAddress;
   if_live_dmx[F("dss")] = DMXSegmentSpacing;
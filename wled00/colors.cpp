@@ -5,32 +5,87 @@
  */
 
 /*
- * color blend function
+ * color math works on two channels at once (SWAR): R & B and W & G are kept in separate 16 bit lanes
+ * of a 32 bit word (masked with 0x00FF00FF) so that one multiplication scales two channels
+ * results are identical to per-channel calculation since 8x8 bit products never overflow a lane
  */
-uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16) {
-  if (blend == 0) return color1;
-  unsigned blendmax = b16 ? 0xFFFF : 0xFF;
-  if (blend == blendmax) return color2;
-  unsigned shift = b16 ? 16 : 8;
 
-  uint32_t w1 = W(color1);
-  uint32_t r1 = R(color1);
-  uint32_t g1 = G(color1);
-  uint32_t b1 = B(color1);
+static constexpr uint32_t TWO_CHANNEL_MASK = 0x00FF00FF;
 
-  uint32_t w2 = W(color2);
-  uint32_t r2 = R(color2);
-  uint32_t g2 = G(color2);
-  uint32_t b2 = B(color2);
+// single color kernels shared by the color functions below and their batch (span) variants
 
-  uint32_t w3 = ((w2 * blend) + (w1 * (blendmax - blend))) >> shift;
-  uint32_t r3 = ((r2 * blend) + (r1 * (blendmax - blend))) >> shift;
-  uint32_t g3 = ((g2 * blend) + (g1 * (blendmax - blend))) >> shift;
-  uint32_t b3 = ((b2 * blend) + (b1 * (blendmax - blend))) >> shift;
+// 8 bit blend, inv = 0xFF - blend
+[[gnu::always_inline]] static inline uint32_t blend8(uint32_t color1, uint32_t color2, uint32_t blend, uint32_t inv) {
+  uint32_t rb1 =  color1       & TWO_CHANNEL_MASK;
+  uint32_t wg1 = (color1 >> 8) & TWO_CHANNEL_MASK;
+  uint32_t rb2 =  color2       & TWO_CHANNEL_MASK;
+  uint32_t wg2 = (color2 >> 8) & TWO_CHANNEL_MASK;
+  uint32_t rb3 = ((rb2 * blend) + (rb1 * inv)) >> 8;
+  uint32_t wg3 = ((wg2 * blend) + (wg1 * inv));
+  return (rb3 & TWO_CHANNEL_MASK) | (wg3 & ~TWO_CHANNEL_MASK);
+}
 
+// 16 bit blend, inv = 0xFFFF - blend (16 bit products do not fit a 16 bit lane, each channel is blended separately)
+[[gnu::always_inline]] static inline uint32_t blend16(uint32_t color1, uint32_t color2, uint32_t blend, uint32_t inv) {
+  uint32_t w3 = ((W(color2) * blend) + (W(color1) * inv)) >> 16;
+  uint32_t r3 = ((R(color2) * blend) + (R(color1) * inv)) >> 16;
+  uint32_t g3 = ((G(color2) * blend) + (G(color1) * inv)) >> 16;
+  uint32_t b3 = ((B(color2) * blend) + (B(color1) * inv)) >> 16;
   return RGBW32(r3, g3, b3, w3);
 }
 
+// saturating add (black needs no special case)
+[[gnu::always_inline]] static inline uint32_t addSaturate(uint32_t c1, uint32_t c2) {
+  uint32_t rb = ( c1       & TWO_CHANNEL_MASK) + ( c2       & TWO_CHANNEL_MASK); // mask and add two colors at once (9 bit lanes)
+  uint32_t wg = ((c1 >> 8) & TWO_CHANNEL_MASK) + ((c2 >> 8) & TWO_CHANNEL_MASK);
+  // saturate overflowing lanes: 0x0100 - 0x0001 = 0x00FF
+  uint32_t rbo = rb & 0x01000100;
+  uint32_t wgo = wg & 0x01000100;
+  rb = (rb | (rbo - (rbo >> 8))) & TWO_CHANNEL_MASK;
+  wg = (wg | (wgo - (wgo >> 8))) & TWO_CHANNEL_MASK;
+  return rb | (wg << 8);
+}
+
+// ratio preserving add (black needs no special case)
+[[gnu::always_inline]] static inline uint32_t addPreserve(uint32_t c1, uint32_t c2) {
+  uint32_t rb = ( c1       & TWO_CHANNEL_MASK) + ( c2       & TWO_CHANNEL_MASK);
+  uint32_t wg = ((c1 >> 8) & TWO_CHANNEL_MASK) + ((c2 >> 8) & TWO_CHANNEL_MASK);
+  if (((rb | wg) & 0x01000100) == 0) return rb | (wg << 8); // no overflow
+  uint32_t r = rb >> 16;
+  uint32_t g = wg & 0xFFFF;
+  uint32_t b = rb & 0xFFFF;
+  uint32_t w = wg >> 16;
+  unsigned max = r;
+  if (g > max) max = g;
+  if (b > max) max = b;
+  if (w > max) max = w;
+  return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
+}
+
+// fade (black stays black), video adds 1 to every non-zero channel if scale > 0
+[[gnu::always_inline]] static inline uint32_t fadeScale(uint32_t c1, uint32_t scale, bool video) {
+  uint32_t rb =  c1       & TWO_CHANNEL_MASK; // color order is: W R G B from MSB to LSB
+  uint32_t wg = (c1 >> 8) & TWO_CHANNEL_MASK;
+  uint32_t scaledcolor = (((rb * scale) >> 8) & TWO_CHANNEL_MASK) | ((wg * scale) & ~TWO_CHANNEL_MASK);
+  if (video) {
+    // add 1 to every non-zero channel (x + 0xFF sets bit 8 of a lane if x > 0)
+    scaledcolor += (( rb + TWO_CHANNEL_MASK) >> 8) & 0x00010001;
+    scaledcolor += (((wg + TWO_CHANNEL_MASK) >> 8) & 0x00010001) << 8;
+  }
+  return scaledcolor;
+}
+
+/*
+ * color blend function
+ */
+uint32_t color_blend(uint32_t color1, uint32_t color2, uint16_t blend, bool b16) {
+  if (blend == 0) return color1;
+  unsigned blendmax = b16 ? 0xFFFF : 0xFF;
+  if (blend == blendmax) return color2;
+  if (b16) return blend16(color1, color2, blend, blendmax - blend);
+  return blend8(color1, color2, blend, blendmax - blend);
+}
+
 /*
  * color add function that preserves ratio
  * idea: https://github.com/Aircoookie/WLED/pull/2465 by https://github.com/Proto-molecule
@@ -39,28 +94,7 @@ uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
 {
   if (c1 == BLACK) return c2;
   if (c2 == BLACK) return c1;
-  if (fast) {
-    uint8_t r = R(c1);
-    uint8_t g = G(c1);
-    uint8_t b = B(c1);
-    uint8_t w = W(c1);
-    r = qadd8(r, R(c2));
-    g = qadd8(g, G(c2));
-    b = qadd8(b, B(c2));
-    w = qadd8(w, W(c2));
-    return RGBW32(r,g,b,w);
-  } else {
-    uint32_t r = R(c1) + R(c2);
-    uint32_t g = G(c1) + G(c2);
-    uint32_t b = B(c1) + B(c2);
-    uint32_t w = W(c1) + W(c2);
-    unsigned max = r;
-    if (g > max) max = g;
-    if (b > max) max = b;
-    if (w > max) max = w;
-    if (max < 256) return RGBW32(r, g, b, w);
-    else           return RGBW32(r * 255 / max, g * 255 / max, b * 255 / max, w * 255 / max);
-  }
+  return fast ? addSaturate(c1, c2) : addPreserve(c1, c2);
 }
 
 /*
@@ -70,25 +104,36 @@ uint32_t color_add(uint32_t c1, uint32_t c2, bool fast)
 
 uint32_t color_fade(uint32_t c1, uint8_t amount, bool video)
 {
-  if (c1 == BLACK || amount + video == 0) return BLACK;
-  uint32_t scaledcolor; // color order is: W R G B from MSB to LSB
-  uint32_t r = R(c1);
-  uint32_t g = G(c1);
-  uint32_t b = B(c1);
-  uint32_t w = W(c1);
-  uint32_t scale = amount; // 32bit for faster calculation
-  if (video) {
-    scaledcolor  = (((r * scale) >> 8) + ((r && scale) ? 1 : 0)) << 16;
-    scaledcolor |= (((g * scale) >> 8) + ((g && scale) ? 1 : 0)) << 8;
-    scaledcolor |=  ((b * scale) >> 8) + ((b && scale) ? 1 : 0);
-    scaledcolor |= (((w * scale) >> 8) + ((w && scale) ? 1 : 0)) << 24;
-  } else {
-    scaledcolor  = ((r * scale) >> 8) << 16;
-    scaledcolor |= ((g * scale) >> 8) << 8;
-    scaledcolor |=  (b * scale) >> 8;
-    scaledcolor |= ((w * scale) >> 8) << 24;
-  }
-  return scaledcolor;
+  if (c1 == BLACK || amount == 0) return BLACK;
+  return fadeScale(c1, amount, video);
+}
+
+/*
+ * batch variants operating on contiguous pixel arrays (i.e. segment pixel buffer)
+ * options are resolved once per span, the loops only run the kernel
+ */
+void fadeSpan(uint32_t *span, size_t len, uint8_t amount, bool video)
+{
+  if (amount == 0) { memset(span, 0, len * sizeof(uint32_t)); return; }
+  const uint32_t scale = amount;
+  if (video) for (size_t i = 0; i < len; i++) span[i] = fadeScale(span[i], scale, true);
+  else       for (size_t i = 0; i < len; i++) span[i] = fadeScale(span[i], scale, false);
+}
+
+void blendSpan(uint32_t *dst, const uint32_t *src, size_t len, uint16_t blend, bool b16)
+{
+  if (blend == 0) return;
+  const uint32_t blendmax = b16 ? 0xFFFF : 0xFF;
+  if (blend == blendmax) { memmove(dst, src, len * sizeof(uint32_t)); return; }
+  const uint32_t inv = blendmax - blend;
+  if (b16) for (size_t i = 0; i < len; i++) dst[i] = blend16(dst[i], src[i], blend, inv);
+  else     for (size_t i = 0; i < len; i++) dst[i] = blend8(dst[i], src[i], blend, inv);
+}
+
+void addSpan(uint32_t *dst, const uint32_t *src, size_t len, bool fast)
+{
+  if (fast) for (size_t i = 0; i < len; i++) dst[i] = addSaturate(dst[i], src[i]);
+  else      for (size_t i = 0; i < len; i++) dst[i] = addPreserve(dst[i], src[i]);
 }
 
 void setRandomColor(byte* rgb)
@@ -400,17 +445,25 @@ static inline float maxf(float v, float w)
 // called from bus manager when color correction is enabled!
 uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb)
 {
-  //remember so that slow colorKtoRGB() doesn't have to run for every setPixelColor()
-  static byte correctionRGB[4] = {0,0,0,0};
-  static uint16_t lastKelvin = 0;
-  if (lastKelvin != kelvin) colorKtoRGB(kelvin, correctionRGB);  // convert Kelvin to RGB
-  lastKelvin = kelvin;
-  byte rgbw[4];
-  rgbw[0] = ((uint16_t) correctionRGB[0] * R(rgb)) /255; // correct R
-  rgbw[1] = ((uint16_t) correctionRGB[1] * G(rgb)) /255; // correct G
-  rgbw[2] = ((uint16_t) correctionRGB[2] * B(rgb)) /255; // correct B
-  rgbw[3] =                                W(rgb);
-  return RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
+  //remember last few corrections so that slow colorKtoRGB() doesn't have to run for every setPixelColor()
+  //(segments with different CCT are written to the same bus in every frame)
+  static struct { uint16_t kelvin; uint16_t mul[3]; } cache[4] = {};
+  static uint8_t last = 0, next = 0;
+  if (cache[last].kelvin != kelvin) {
+    unsigned i = 0;
+    while (i < 4 && cache[i].kelvin != kelvin) i++;
+    if (i == 4) {
+      byte correctionRGB[4];
+      colorKtoRGB(kelvin, correctionRGB);  // convert Kelvin to RGB
+      i = next;
+      next = (next + 1) & 3;
+      cache[i].kelvin = kelvin;
+      for (unsigned j = 0; j < 3; j++) cache[i].mul[j] = correctionRGB[j] * 257; // (x * mul + 255) >> 16 == (x * corr) / 255
+    }
+    last = i;
+  }
+  const uint16_t *mul = cache[last].mul;
+  return RGBW32((R(rgb) * mul[0] + 255) >> 16, (G(rgb) * mul[1] + 255) >> 16, (B(rgb) * mul[2] + 255) >> 16, W(rgb));
 }
 
 //approximates a Kelvin color temperature from an RGB color.
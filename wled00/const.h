@@ -249,6 +249,14 @@
 #define REALTIME_MODE_TPM2NET     7
 #define REALTIME_MODE_DDP         8
 
+#define RT_PLAYOUT_MAX_DEPTH      3    // max. frames held in realtime playout (jitter) buffer
+
+//realtime inputs using direct output (realtimeDirect bits)
+#define RT_DIRECT_DDP             0x01
+#define RT_DIRECT_DMX             0x02 // E1.31 & Art-Net
+#define RT_DIRECT_UDP             0x04 // UDP realtime, Hyperion & TPM2.NET
+#define RT_DIRECT_SERIAL          0x08 // Adalight & TPM2
+
 //realtime override modes
 #define REALTIME_OVERRIDE_NONE    0
 #define REALTIME_OVERRIDE_ONCE    1
@@ -560,6 +568,16 @@
 //#define MIN_HEAP_SIZE (8k for AsyncWebServer)
 #define MIN_HEAP_SIZE 8192
 
+// Serial (Adalight/TPM2) receive buffer and max. baud rate (divided by 100)
+#ifndef WLED_SERIAL_RX_BUFSIZE
+  #ifdef ESP8266
+    #define WLED_SERIAL_RX_BUFSIZE 1024
+  #else
+    #define WLED_SERIAL_RX_BUFSIZE 4096
+  #endif
+#endif
+#define WLED_SERIAL_MAX_BAUD 40000
+
 // Maximum size of node map (list of other WLED instances)
 #ifdef ESP8266
   #define WLED_MAX_NODES 24
@@ -8,6 +8,108 @@
  * E1.31 handler
  */
 
+// LEDs carried by each universe in multiple LED DMX modes
+typedef struct {
+  uint16_t start;   // first LED
+  uint16_t count;   // number of LEDs (clipped to strip length)
+  uint16_t offset;  // index of first LED's data in Art-Net payload (E1.31 payload has additional start code)
+} e131universe_t;
+
+static e131universe_t e131Map[E131_MAX_UNIVERSE_COUNT];
+static uint16_t e131MapUniverse, e131MapAddress, e131MapLength;
+static uint8_t  e131MapMode = DMX_MODE_DISABLED;
+static uint32_t e131ExpectedMask = 1;    // universes (bit 0 = e131Universe) making up a complete frame
+
+// frame assembly (used if e131WaitForFrame is set), universes are staged in realtime playout buffer
+// state is shared by network callback and handleE131Timeout() in loop(), access only with lockRealtimePlayout() held
+#define E131_SYNC_TIMEOUT 4000           // ms without sync packets before falling back to unsynchronized frames
+static uint32_t e131FrameMask  = 0;      // universes received for frame being assembled
+static uint32_t e131LateMask   = 0;      // universes missing from last presented frame
+static uint32_t e131FrameStart = 0;      // millis() when first universe of frame arrived
+static uint32_t e131SyncTime   = 0;      // millis() when last sync packet arrived
+static uint16_t e131SyncAddress = 0;     // sync universe announced by E1.31 data packets
+
+// rebuilds universe layout if settings or strip length changed since last packet
+static void updateE131Map() {
+  const unsigned totalLen = strip.getLengthTotal();
+  if (e131MapMode == DMXMode && e131MapUniverse == e131Universe && e131MapAddress == DMXAddress && e131MapLength == totalLen) return;
+
+  const bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
+  const unsigned dmxChannelsPerLed = is4Chan ? 4 : 3;
+  const unsigned ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+  const unsigned dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0; // first DMX address is dimmer in DMX_MODE_MULTIPLE_DRGB mode
+  const unsigned dmxLenOffset = (DMXAddress == 0) ? 0 : 1; // for legacy DMX start address 0
+  const unsigned ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
+
+  unsigned start = 0;
+  e131ExpectedMask = 0;
+  for (unsigned u = 0; u < E131_MAX_UNIVERSE_COUNT; u++) {
+    const unsigned leds = u ? ledsPerUniverse : ledsInFirstUniverse;
+    e131Map[u].start  = start < totalLen ? start : totalLen;
+    e131Map[u].count  = start < totalLen ? min(leds, totalLen - start) : 0;
+    e131Map[u].offset = u ? 0 : (DMXAddress ? DMXAddress - 1 : 0) + dimmerOffset; // all subsequent universes start at the first channel
+    if (e131Map[u].count) e131ExpectedMask |= 1UL << u;
+    start += leds;
+  }
+  // only DMX_MODE_MULTIPLE_* modes span over consecutive universes
+  if (DMXMode != DMX_MODE_MULTIPLE_RGB && DMXMode != DMX_MODE_MULTIPLE_RGBW && DMXMode != DMX_MODE_MULTIPLE_DRGB) e131ExpectedMask = 1;
+
+  e131MapMode     = DMXMode;
+  e131MapUniverse = e131Universe;
+  e131MapAddress  = DMXAddress;
+  e131MapLength   = totalLen;
+}
+
+static inline bool e131SyncActive() {
+  return e131SyncTime && millis() - e131SyncTime < E131_SYNC_TIMEOUT;
+}
+
+// hands assembled frame over to handleNotifications() for showing
+static void presentE131Frame() {
+  if ((e131FrameMask & e131ExpectedMask) != e131ExpectedMask) e131PartialFrames++;
+  e131LateMask  = e131ExpectedMask & ~e131FrameMask;
+  e131FrameMask = 0;
+  e131Frames++;
+  presentRealtimeFrame(false, 0);
+}
+
+// adds universe to frame being assembled, frame is presented once all universes arrived (unless sync packets are used)
+static void addE131Universe(unsigned u) {
+  if (!e131WaitForFrame) {
+    e131NewData = true;
+    return;
+  }
+  const uint32_t bit = 1UL << u;
+  if (e131FrameMask & bit) presentE131Frame(); // next frame started before this one was complete
+  if (!e131FrameMask) e131FrameStart = millis();
+  e131FrameMask |= bit;
+  if (!e131SyncActive() && (e131FrameMask & e131ExpectedMask) == e131ExpectedMask) presentE131Frame();
+}
+
+// a packet is late if it belongs to a frame that was presented without it (its sequence number directly follows the last one received)
+static bool isLateE131Packet(unsigned u, uint8_t seq) {
+  const uint32_t bit = 1UL << u;
+  if (!e131WaitForFrame || !(e131LateMask & bit)) return false;
+  e131LateMask &= ~bit;
+  if (seq == 0 || uint8_t(seq - e131LastSequenceNumber[u]) != 1) return false; // lost packet (or no sequence numbers), this one is from new frame
+  e131LatePackets++;
+  return true;
+}
+
+// E1.31 synchronization or ArtSync packet: show frame assembled so far
+static void handleE131Sync() {
+  e131SyncTime = millis();
+  if (e131WaitForFrame && e131FrameMask) presentE131Frame();
+}
+
+// shows incomplete frame if missing universes did not arrive in time (called from handleNotifications())
+void handleE131Timeout() {
+  if (!e131FrameMask) return;
+  lockRealtimePlayout();
+  if (e131FrameMask && !e131SyncActive() && millis() - e131FrameStart > e131FrameTimeout) presentE131Frame();
+  unlockRealtimePlayout();
+}
+
 //DDP protocol support, called by handleE131Packet
 //handles RGB data only
 void handleDDPPacket(e131_packet_t* p) {
@@ -33,28 +135,39 @@ void handleDDPPacket(e131_packet_t* p) {
   unsigned stop = start + htons(p->dataLen) / ddpChannelsPerLed;
   uint8_t* data = p->data;
   unsigned c = 0;
-  if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
+  uint32_t timecode = 0;
+  bool hasTimecode = p->flags & DDP_TIMECODE_FLAG;
+  if (hasTimecode) { //packet has timecode (used by playout buffer), data starts 4 bytes later
+    timecode = (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+    c = 4;
+  }
 
   if (realtimeMode != REALTIME_MODE_DDP) ddpSeenPush = false; // just starting, no push yet
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
-  if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
-    for (unsigned i = start; i < stop; i++, c += ddpChannelsPerLed) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
-    }
+  if ((!realtimeOverride || (realtimeMode && useMainSegmentOnly)) && stop > start && start <= UINT16_MAX) {
+    setRealtimePixels(start, min(unsigned(stop - start), unsigned(UINT16_MAX)), data + c, ddpChannelsPerLed, ddpChannelsPerLed);
   }
 
   bool push = p->flags & DDP_PUSH_FLAG;
   ddpSeenPush |= push;
   if (!ddpSeenPush || push) { // if we've never seen a push, or this is one, render display
-    e131NewData = true;
+    presentRealtimeFrame(hasTimecode, timecode);
     int sn = p->sequenceNum & 0xF;
     if (sn) e131LastSequenceNumber[0] = sn;
   }
 }
 
-//E1.31 and Art-Net protocol support
+static void handleRealtimePacket(e131_packet_t* p, IPAddress clientIP, byte protocol);
+
+//E1.31, Art-Net and DDP protocol support (network callback)
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
+  lockRealtimePlayout(); // frame assembly is shared with loop()
+  handleRealtimePacket(p, clientIP, protocol);
+  unlockRealtimePlayout();
+}
+
+static void handleRealtimePacket(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   int uni = 0, dmxChannels = 0;
   uint8_t* e131_data = nullptr;
@@ -66,12 +179,20 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       handleArtnetPollReply(clientIP);
       return;
     }
+    if (p->art_opcode == ARTNET_OPCODE_OPSYNC) {
+      handleE131Sync();
+      return;
+    }
     uni = p->art_universe;
     dmxChannels = htons(p->art_length);
     e131_data = p->art_data;
     seq = p->art_sequence_number;
     mde = REALTIME_MODE_ARTNET;
   } else if (protocol == P_E131) {
+    if (htonl(p->root_vector) == E131_VECTOR_ROOT_EXTENDED) { // synchronization packet
+      if (e131SyncAddress && htons(p->sync_universe) == e131SyncAddress) handleE131Sync();
+      return;
+    }
     // Ignore PREVIEW data (E1.31: 6.2.6)
     if ((p->options & 0x80) != 0) return;
     dmxChannels = htons(p->property_value_count) - 1;
@@ -80,6 +201,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     uni = htons(p->universe);
     e131_data = p->property_values;
     seq = p->sequence_number;
+    e131SyncAddress = htons(p->sync_address);
     if (e131Priority != 0) {
       if (p->priority < e131Priority ) return;
       // track highest priority & skip all lower priorities
@@ -111,11 +233,12 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       DEBUG_PRINTF_P(PSTR("skipping E1.31 frame (last seq=%d, current seq=%d, universe=%d)\n"), e131LastSequenceNumber[previousUniverses], seq, uni);
       return;
     }
+  const bool late = isLateE131Packet(previousUniverses, seq);
   e131LastSequenceNumber[previousUniverses] = seq;
+  if (late) return; // its frame was already shown
 
   // update status info
   realtimeIP = clientIP;
-  byte wChannel = 0;
   unsigned totalLen = strip.getLengthTotal();
   unsigned availDMXLen = 0;
   unsigned dataOffset = DMXAddress;
@@ -146,9 +269,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
-      wChannel = (availDMXLen > 3) ? e131_data[dataOffset+3] : 0;
-      for (unsigned i = 0; i < totalLen; i++)
-        setRealtimePixel(i, e131_data[dataOffset+0], e131_data[dataOffset+1], e131_data[dataOffset+2], wChannel);
+      setRealtimePixels(0, totalLen, e131_data + dataOffset, (availDMXLen > 3) ? 4 : 3, 0); // same color for all LEDs
       break;
 
     case DMX_MODE_SINGLE_DRGB:  // 4 channel: [Dimmer,R,G,B]
@@ -157,15 +278,13 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
       realtimeLock(realtimeTimeoutMs, mde);
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      wChannel = (availDMXLen > 4) ? e131_data[dataOffset+4] : 0;
 
       if (bri != e131_data[dataOffset+0]) {
         bri = e131_data[dataOffset+0];
         strip.setBrightness(bri, true);
       }
 
-      for (unsigned i = 0; i < totalLen; i++)
-        setRealtimePixel(i, e131_data[dataOffset+1], e131_data[dataOffset+2], e131_data[dataOffset+3], wChannel);
+      setRealtimePixels(0, totalLen, e131_data + dataOffset + 1, (availDMXLen > 4) ? 4 : 3, 0); // same color for all LEDs
       break;
 
     case DMX_MODE_PRESET:       // 2 channel: [Dimmer,Preset]
@@ -263,62 +382,27 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     case DMX_MODE_MULTIPLE_RGB:
     case DMX_MODE_MULTIPLE_RGBW:
       {
-        bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
-        const unsigned dmxChannelsPerLed = is4Chan ? 4 : 3;
-        const unsigned ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
-        uint8_t stripBrightness = bri;
-        unsigned previousLeds, dmxOffset, ledsTotal;
-
-        if (previousUniverses == 0) {
-          if (availDMXLen < 1) return;
-          dmxOffset = dataOffset;
-          previousLeds = 0;
-          // First DMX address is dimmer in DMX_MODE_MULTIPLE_DRGB mode.
-          if (DMXMode == DMX_MODE_MULTIPLE_DRGB) {
-            stripBrightness = e131_data[dmxOffset++];
-            ledsTotal = (availDMXLen - 1) / dmxChannelsPerLed;
-          } else {
-            ledsTotal = availDMXLen / dmxChannelsPerLed;
-          }
-        } else {
-          // All subsequent universes start at the first channel.
-          dmxOffset = (protocol == P_ARTNET) ? 0 : 1;
-          const unsigned dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
-          unsigned ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
-          previousLeds = ledsInFirstUniverse + (previousUniverses - 1) * ledsPerUniverse;
-          ledsTotal = previousLeds + (dmxChannels / dmxChannelsPerLed);
-        }
+        updateE131Map();
+        const e131universe_t &map = e131Map[previousUniverses];
+        const unsigned dmxChannelsPerLed = (DMXMode == DMX_MODE_MULTIPLE_RGBW) ? 4 : 3;
+        const bool hasDimmer = (DMXMode == DMX_MODE_MULTIPLE_DRGB && previousUniverses == 0);
 
-        // All LEDs already have values
-        if (previousLeds >= totalLen) {
-          return;
-        }
+        // All LEDs already have values (or universe holds no LED data)
+        if (map.count == 0 || dmxChannels + hasDimmer <= map.offset) return;
+
+        // E1.31 data is preceded by start code (legacy DMX start address 0 reads from it)
+        const unsigned dmxOffset = map.offset + (protocol == P_E131 && (previousUniverses > 0 || DMXAddress > 0));
+        const unsigned ledsTotal = min((unsigned)map.count, (dmxChannels - map.offset) / dmxChannelsPerLed);
 
         realtimeLock(realtimeTimeoutMs, mde);
         if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
-        if (ledsTotal > totalLen) {
-          ledsTotal = totalLen;
-        }
-
-        if (DMXMode == DMX_MODE_MULTIPLE_DRGB && previousUniverses == 0) {
-          if (bri != stripBrightness) {
-            bri = stripBrightness;
-            strip.setBrightness(bri, true);
-          }
+        if (hasDimmer && bri != e131_data[dmxOffset-1]) {
+          bri = e131_data[dmxOffset-1];
+          strip.setBrightness(bri, true);
         }
 
-        if (!is4Chan) {
-          for (unsigned i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (unsigned i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
-          }
-        }
+        setRealtimePixels(map.start, ledsTotal, e131_data + dmxOffset, dmxChannelsPerLed, dmxChannelsPerLed);
         break;
       }
     default:
@@ -327,7 +411,8 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       break;
   }
 
-  e131NewData = true;
+  updateE131Map();
+  addE131Universe(previousUniverses);
 }
 
 void handleArtnetPollReply(IPAddress ipAddress) {
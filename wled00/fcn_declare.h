@@ -81,6 +81,9 @@ class NeoGammaWLEDMethod {
 [[gnu::hot]] uint32_t color_blend(uint32_t,uint32_t,uint16_t,bool b16=false);
 [[gnu::hot]] uint32_t color_add(uint32_t,uint32_t, bool fast=false);
 [[gnu::hot]] uint32_t color_fade(uint32_t c1, uint8_t amount, bool video=false);
+void fadeSpan(uint32_t *span, size_t len, uint8_t amount, bool video=false);                     // fades len colors in place
+void blendSpan(uint32_t *dst, const uint32_t *src, size_t len, uint16_t blend, bool b16=false); // blends src over dst
+void addSpan(uint32_t *dst, const uint32_t *src, size_t len, bool fast=false);                  // adds src to dst
 CRGBPalette16 generateHarmonicRandomPalette(CRGBPalette16 &basepalette);
 CRGBPalette16 generateRandomPalette();
 inline uint32_t colorFromRgbw(byte* rgbw) { return uint32_t((byte(rgbw[3]) << 24) | (byte(rgbw[0]) << 16) | (byte(rgbw[1]) << 8) | (byte(rgbw[2]))); }
@@ -101,6 +104,7 @@ void handleDMX();
 
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleE131Timeout();
 void handleArtnetPollReply(IPAddress ipAddress);
 void prepareArtnetPollReply(ArtPollReply* reply);
 void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
@@ -158,6 +162,7 @@ bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE,
 void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
 void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false);
 void serializeInfo(JsonObject root);
+void serializePerf(JsonObject root);
 void serializeModeNames(JsonArray root);
 void serializeModeData(JsonArray root);
 void serveJson(AsyncWebServerRequest* request);
@@ -239,11 +244,19 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=tru
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
+struct NetBusStats;
+uint8_t realtimeBroadcast(uint8_t type, const IPAddress *clients, NetBusStats **stats, uint8_t numClients, uint16_t length, const uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t i, uint16_t count, const uint8_t *data, uint8_t channels, uint8_t stride);
+bool realtimeDirectOutput();
+void presentRealtimeFrame(bool hasTimecode, uint32_t timecode);
+void lockRealtimePlayout();   // guards realtime frame assembly and playout buffer against network callbacks (ESP32)
+void unlockRealtimePlayout();
+void handleRealtimePlayout();
+unsigned realtimePlayoutQueued();
 void refreshNodeList();
 void sendSysInfoUDP();
 #ifndef WLED_DISABLE_ESPNOW
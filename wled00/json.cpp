@@ -261,20 +261,18 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
 
   JsonArray iarr = elem[F("i")]; //set individual LEDs
   if (!iarr.isNull()) {
-    uint8_t oldMap1D2D = seg.map1D2D;
-    seg.map1D2D = M12_Pixels; // no mapping
-
     // set brightness immediately and disable transition
     jsonTransitionOnce = true;
     seg.stopTransition();
     strip.setTransition(0);
     strip.setBrightness(scaledBri(bri), true);
 
-    // freeze and init to black
-    if (!seg.freeze) {
-      seg.freeze = true;
-      seg.fill(BLACK);
-    }
+    // pixels are indexed like the pixel buffer (no mapping) and staged, WS2812FX::service() copies them into it
+    // (it may be rendering or reallocating the pixel buffer right now, strip.suspend() does not wait for it)
+    // freeze, a segment that was not frozen yet starts black
+    const unsigned pxLen = seg.bufferLength();
+    uint32_t *px = seg.newStagedPixels(seg.freeze);
+    seg.freeze = true;
 
     start = 0, stop = 0;
     set = 0; //0 nothing set, 1 start set, 2 range set
@@ -304,11 +302,11 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
 
         if (set < 2 || stop <= start) stop = start + 1;
         uint32_t c = gamma32(RGBW32(rgbw[0], rgbw[1], rgbw[2], rgbw[3]));
-        while (start < stop) seg.setPixelColor(start++, c);
+        if (px) for (; start < stop && (unsigned)start < pxLen; start++) px[start] = c;
         set = 0;
       }
     }
-    seg.map1D2D = oldMap1D2D; // restore mapping
+    if (px) seg.stagePixels(px, pxLen);
     strip.trigger(); // force segment update
   }
   // send UDP/WS if segment options changed (except selection; will also deselect current preset)
@@ -362,6 +360,9 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     if (fadeTransition) strip.setTransition(tr * 100);
   }
 
+  blendingStyle = root[F("bs")] | blendingStyle;
+  if (blendingStyle >= BLEND_STYLE_COUNT) blendingStyle = BLEND_STYLE_FADE;
+
   tr = root[F("tb")] | -1;
   if (tr >= 0) strip.timebase = (unsigned long)tr - millis();
 
@@ -587,6 +588,7 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
     root["on"] = (bri > 0);
     root["bri"] = briLast;
     root[F("transition")] = transitionDelay/100; //in 100ms
+    if (!forPreset) root[F("bs")] = blendingStyle;
   }
 
   if (!forPreset) {
@@ -638,6 +640,41 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 }
 
+// render & output timings (in us) over last few frames
+void serializePerf(JsonObject root)
+{
+  perfstats_t st;
+  auto addStats = [&](JsonObject obj) {
+    obj[F("min")] = st.min;
+    obj[F("avg")] = st.avg;
+    obj[F("max")] = st.max;
+    obj[F("p90")] = st.p90;
+    obj["n"]      = st.count;
+  };
+  if (PerfCounters::getStats(PERF_FRAME, st)) addStats(root.createNestedObject(F("frame")));
+  if (PerfCounters::getStats(PERF_BLEND, st)) addStats(root.createNestedObject(F("blend")));
+  if (PerfCounters::getStats(PERF_SHOW, st))  addStats(root.createNestedObject(F("show")));
+  if (PerfCounters::getStats(PERF_ABL, st))   addStats(root.createNestedObject(F("abl")));
+  if (PerfCounters::getStats(PERF_WIRE, st))  addStats(root.createNestedObject(F("wire")));
+
+  JsonArray buses = root.createNestedArray(F("bus"));
+  for (size_t b = 0; b < BusManager::getNumBusses() && b < WLED_MAX_BUSSES; b++) {
+    if (!PerfCounters::getStats(PERF_BUS + b, st)) continue;
+    JsonObject obj = buses.createNestedObject();
+    obj["id"] = b;
+    addStats(obj);
+  }
+  JsonArray segs = root.createNestedArray("seg");
+  for (size_t s = 0; s < strip.getSegmentsNum() && s < PERF_SEGMENTS; s++) {
+    Segment &sg = strip.getSegment(s);
+    if (!sg.isActive() || !PerfCounters::getStats(PERF_SEGMENT + s, st)) continue;
+    JsonObject obj = segs.createNestedObject();
+    obj["id"] = s;
+    obj["fx"] = sg.mode;
+    addStats(obj);
+  }
+}
+
 void serializeInfo(JsonObject root)
 {
   root[F("ver")] = versionString;
@@ -655,6 +692,48 @@ void serializeInfo(JsonObject root)
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
   leds[F("bootps")] = bootPreset;
 
+  Segment::arenainfo_t arena;
+  Segment::getArenaInfo(arena);
+  JsonObject fxmem = leds.createNestedObject(F("fxmem")); // effect data arena
+  fxmem[F("size")]  = arena.size;
+  fxmem[F("used")]  = arena.used;
+  fxmem[F("free")]  = arena.size - arena.used;
+  fxmem[F("lrgst")] = arena.largest;
+  fxmem[F("cmpct")] = arena.compactions;
+  fxmem[F("data")]  = Segment::getUsedSegmentData(); // all effect data (in arena or on heap), limited by MAX_SEGMENT_DATA
+
+  JsonObject sched = leds.createNestedObject(F("sched")); // frame scheduler
+  uint32_t budget = strip.getFrameBudgetUs();
+  sched[F("bdg")] = budget;                 // us per frame (0 = unlimited)
+  sched[F("use")] = strip.getRenderTime();  // us used by effects in last frame
+  JsonArray schedSeg = sched.createNestedArray(F("seg"));
+  for (size_t s = 0; s < strip.getSegmentsNum(); s++) {
+    const Segment &sg = strip.getSegment(s);
+    if (!sg.isActive()) continue;
+    JsonObject ss = schedSeg.createNestedObject();
+    ss["id"]        = s;
+    ss["fps"]       = sg.sched.fps;
+    ss["us"]        = sg.sched.cost;                               // average render time
+    ss[F("bdg")]    = budget ? sg.sched.cost * 100 / budget : 0;  // % of frame budget
+    ss[F("miss")]   = sg.sched.missed;
+    ss[F("dly")]    = sg.sched.delay;                              // ms added to effect's frame delay
+  }
+
+  JsonArray net = leds.createNestedArray(F("net")); // network bus send statistics (one entry per receiver)
+  for (size_t b = 0; b < BusManager::getNumBusses(); b++) {
+    Bus *bus = BusManager::getBus(b);
+    if (!bus || !bus->isVirtual() || !bus->isOk()) continue;
+    const netstats_t &st = static_cast<BusNetwork*>(bus)->getStats();
+    JsonObject nb = net.createNestedObject();
+    nb["id"]      = b;
+    nb[F("fan")]  = static_cast<BusNetwork*>(bus)->isFollower(); // sent by another bus with the same pixels
+    nb[F("pkt")]  = st.packets;
+    nb[F("err")]  = st.errors;
+    nb[F("kB")]   = st.bytes >> 10;
+    nb["us"]      = st.sendTime;  // time spent sending last frame
+    nb[F("skip")] = st.skipped;   // unchanged or rate limited frames
+  }
+
   #ifndef WLED_DISABLE_2D
   if (strip.isMatrix) {
     JsonObject matrix = leds.createNestedObject(F("matrix"));
@@ -710,6 +789,19 @@ void serializeInfo(JsonObject root)
   }
 
   root[F("lip")] = realtimeIP[0] == 0 ? "" : realtimeIP.toString();
+  if (realtimePlayoutDepth) {
+    JsonObject rtBuf = root.createNestedObject(F("rtbuf")); // realtime playout buffer
+    rtBuf[F("depth")] = realtimePlayoutQueued();
+    rtBuf[F("under")] = rtPlayoutUnderruns;
+    rtBuf[F("drop")]  = rtPlayoutDrops;
+    rtBuf[F("lat")]   = rtPlayoutLatency;
+  }
+  if (e131WaitForFrame) {
+    JsonObject e131Info = root.createNestedObject(F("e131")); // frame assembly statistics
+    e131Info[F("frames")]  = e131Frames;
+    e131Info[F("partial")] = e131PartialFrames;
+    e131Info[F("late")]    = e131LatePackets;
+  }
 
   #ifdef WLED_ENABLE_WEBSOCKETS
   root[F("ws")] = ws.count();
@@ -717,6 +809,9 @@ void serializeInfo(JsonObject root)
   root[F("ws")] = -1;
   #endif
 
+  JsonObject perf = root.createNestedObject(F("perf"));
+  serializePerf(perf);
+
   root[F("fxcount")] = strip.getModeCount();
   root[F("palcount")] = strip.getPaletteCount();
   root[F("cpalcount")] = strip.customPalettes.size(); //number of custom palettes
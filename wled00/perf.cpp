@@ -0,0 +1,51 @@
+#include "wled.h"
+
+/*
+ * Render and output profiling, see perf.h
+ */
+
+PerfCounters::Channel PerfCounters::_channels[PERF_CHANNELS] = {};
+
+void PerfCounters::push(uint8_t ch, uint32_t cycles) {
+  if (ch >= PERF_CHANNELS) return;
+  uint32_t us = cycles / ESP.getCpuFreqMHz();
+  Channel &c = _channels[ch];
+  c.samples[c.pos] = us > UINT16_MAX ? UINT16_MAX : us;
+  c.pos = (c.pos + 1) % PERF_SAMPLES;
+  if (c.count < PERF_SAMPLES) c.count++;
+}
+
+void PerfCounters::record(uint8_t ch, uint32_t start) {
+  push(ch, ESP.getCycleCount() - start);
+}
+
+void PerfCounters::accumulate(uint8_t ch, uint32_t start) {
+  if (ch < PERF_CHANNELS) _channels[ch].pending += ESP.getCycleCount() - start;
+}
+
+void PerfCounters::commit(uint8_t ch) {
+  if (ch >= PERF_CHANNELS || _channels[ch].pending == 0) return;
+  push(ch, _channels[ch].pending);
+  _channels[ch].pending = 0;
+}
+
+bool PerfCounters::getStats(uint8_t ch, perfstats_t &stats) {
+  if (ch >= PERF_CHANNELS || _channels[ch].count == 0) return false;
+  const Channel &c = _channels[ch];
+  uint16_t sorted[PERF_SAMPLES];
+  uint32_t sum = 0;
+  // insertion sort (samples are taken from start of buffer until it wraps)
+  for (unsigned i = 0; i < c.count; i++) {
+    uint16_t s = c.samples[i];
+    sum += s;
+    unsigned j = i;
+    for (; j > 0 && sorted[j-1] > s; j--) sorted[j] = sorted[j-1];
+    sorted[j] = s;
+  }
+  stats.count = c.count;
+  stats.min   = sorted[0];
+  stats.max   = sorted[c.count-1];
+  stats.avg   = sum / c.count;
+  stats.p90   = sorted[(c.count * 90 + 99) / 100 - 1]; // nearest rank
+  return true;
+}
@@ -0,0 +1,58 @@
+#ifndef WLED_PERF_H
+#define WLED_PERF_H
+/*
+ * Render and output profiling (always available, low overhead)
+ * Timings are taken with CPU cycle counter and converted to microseconds. Each channel keeps
+ * last PERF_SAMPLES timings in a ring buffer from which min/avg/max/p90 are calculated on request
+ * (p90: a window of 16 or 32 samples cannot resolve a 99th percentile, it would always be max).
+ */
+
+#include <Arduino.h>
+#include "const.h"
+
+#ifdef ESP8266
+  #define PERF_SAMPLES  16
+  #define PERF_SEGMENTS 16  // same as default MAX_NUM_SEGMENTS, segments above are not profiled
+#else
+  #define PERF_SAMPLES  32
+  #define PERF_SEGMENTS 32
+#endif
+
+// profiling channels
+#define PERF_FRAME    0                           // WS2812FX::service() frame with output (effects, blending, show)
+#define PERF_BLEND    1                           // effect blending overhead (previous effect and composition)
+#define PERF_SHOW     2                           // BusManager::show() (all buses)
+#define PERF_ABL      3                           // brightness limiter (current estimation) on all buses
+#define PERF_WIRE     4                           // frame transfer (from show() until all buses can show again)
+#define PERF_BUS      5                           // show() of each bus
+#define PERF_SEGMENT  (PERF_BUS + WLED_MAX_BUSSES) // effect function of each segment
+#define PERF_CHANNELS (PERF_SEGMENT + PERF_SEGMENTS)
+
+typedef struct PerfStats {
+  uint16_t min;
+  uint16_t avg;
+  uint16_t max;
+  uint16_t p90;
+  uint8_t  count; // number of samples
+} perfstats_t;
+
+class PerfCounters {
+  public:
+    static inline uint32_t start() { return ESP.getCycleCount(); }
+    static void record(uint8_t ch, uint32_t start);     // stores time since start as a new sample
+    static void accumulate(uint8_t ch, uint32_t start); // adds time since start to pending sample of channel
+    static void commit(uint8_t ch);                     // stores pending sample (if there is one)
+    static bool getStats(uint8_t ch, perfstats_t &stats);
+
+  private:
+    struct Channel {
+      uint16_t samples[PERF_SAMPLES]; // in us
+      uint32_t pending;               // accumulated cycles
+      uint8_t  pos;
+      uint8_t  count;
+    };
+    static Channel _channels[PERF_CHANNELS];
+    static void push(uint8_t ch, uint32_t cycles);
+};
+
+#endif
@@ -129,6 +129,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     unsigned ablMilliampsMax = request->arg(F("MA")).toInt();
     BusManager::setMilliampsMax(ablMilliampsMax);
+    BusManager::setABLSmoothing(request->hasArg(F("AS")));
 
     strip.autoSegments = request->hasArg(F("MS"));
     strip.correctWB = request->hasArg(F("CCT"));
@@ -138,6 +139,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     Bus::setCCTBlend(strip.cctBlending);
     Bus::setGlobalAWMode(request->arg(F("AW")).toInt());
     strip.setTargetFps(request->arg(F("FR")).toInt());
+    strip.setFrameBudget(request->arg(F("FB")).toInt());
+    BusNetwork::setKeepAlive(request->arg(F("NK")).toInt());
     useGlobalLedBuffer = request->hasArg(F("LD"));
 
     bool busesChanged = false;
@@ -154,6 +157,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       char aw[4] = "AW"; aw[2] = offset+s; aw[3] = 0; //auto white mode
       char wo[4] = "WO"; wo[2] = offset+s; wo[3] = 0; //channel swap
       char sp[4] = "SP"; sp[2] = offset+s; sp[3] = 0; //bus clock speed (DotStar & PWM)
+      char nr[4] = "NR"; nr[2] = offset+s; nr[3] = 0; //max frame rate (network)
       char la[4] = "LA"; la[2] = offset+s; la[3] = 0; //LED mA
       char ma[4] = "MA"; ma[2] = offset+s; ma[3] = 0; //max mA
       if (!request->hasArg(lp)) {
@@ -194,6 +198,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
           case 3 : freq = 10000; break;
           case 4 : freq = 20000; break;
         }
+      } else if (Bus::isVirtual(type)) {
+        freq = request->arg(nr).toInt(); // max FPS sent to receiver
       } else {
         freq = 0;
       }
@@ -329,6 +335,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     fadeTransition = request->hasArg(F("TF"));
     modeBlending = request->hasArg(F("EB"));
+    t = request->arg(F("BS")).toInt();
+    if (t >= 0 && t < BLEND_STYLE_COUNT) blendingStyle = t;
     t = request->arg(F("TD")).toInt();
     if (t >= 0) transitionDelayDefault = t;
     strip.paletteFade = request->hasArg(F("PF"));
@@ -400,7 +408,18 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     receiveDirect = request->hasArg(F("RD")); // UDP realtime
     useMainSegmentOnly = request->hasArg(F("MO"));
     realtimeRespectLedMaps = request->hasArg(F("RLM"));
+    t = request->arg(F("JB")).toInt();
+    realtimePlayoutDepth = constrain(t, 0, RT_PLAYOUT_MAX_DEPTH);
+    realtimeInterpolate = request->hasArg(F("JI"));
+    realtimeDirect = 0;
+    if (request->hasArg(F("DOD"))) realtimeDirect |= RT_DIRECT_DDP;
+    if (request->hasArg(F("DOE"))) realtimeDirect |= RT_DIRECT_DMX;
+    if (request->hasArg(F("DOU"))) realtimeDirect |= RT_DIRECT_UDP;
+    if (request->hasArg(F("DOS"))) realtimeDirect |= RT_DIRECT_SERIAL;
     e131SkipOutOfSequence = request->hasArg(F("ES"));
+    e131WaitForFrame = request->hasArg(F("EF"));
+    t = request->arg(F("EO")).toInt();
+    if (t > 0) e131FrameTimeout = t;
     e131Multicast = request->hasArg(F("EM"));
     t = request->arg(F("EP")).toInt();
     if (t > 0) e131Port = t;
@@ -463,7 +482,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     #endif
 
     t = request->arg(F("BD")).toInt();
-    if (t >= 96 && t <= 15000) serialBaud = t;
+    if (t >= 96 && t <= WLED_SERIAL_MAX_BAUD) serialBaud = t;
     updateBaudRate(serialBaud *100);
   }
 
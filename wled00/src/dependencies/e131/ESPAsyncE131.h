@@ -59,6 +59,7 @@ typedef struct ip_addr ip4_addr_t;
 #define ARTNET_OPCODE_OPDMX 0x5000
 #define ARTNET_OPCODE_OPPOLL 0x2000
 #define ARTNET_OPCODE_OPPOLLREPLY 0x2100
+#define ARTNET_OPCODE_OPSYNC 0x5200
 
 #define P_E131   0
 #define P_ARTNET 1
@@ -72,6 +73,10 @@ typedef struct ip_addr ip4_addr_t;
 #define E131_ROOT_VECTOR 18
 #define E131_ROOT_CID 22
 
+// E1.31 Synchronization Packet
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008
+#define E131_VECTOR_EXTENDED_SYNC 0x00000001
+
 #define E131_FRAME_FLENGTH 38
 #define E131_FRAME_VECTOR 40
 #define E131_FRAME_SOURCE 44
@@ -105,7 +110,7 @@ typedef union {
       uint32_t frame_vector;
       uint8_t  source_name[64];
       uint8_t  priority;
-      uint16_t reserved;
+      uint16_t sync_address; // universe of synchronization packets (0 = not synchronized)
       uint8_t  sequence_number;
       uint8_t  options;
       uint16_t universe;
@@ -120,6 +125,15 @@ typedef union {
       uint8_t  property_values[513];
     } __attribute__((packed));
 	
+	struct { //E1.31 synchronization packet (root layer same as above)
+      uint8_t  sync_root[38];
+      uint16_t sync_flength;
+      uint32_t sync_vector;
+      uint8_t  sync_sequence_number;
+      uint16_t sync_universe;
+      uint16_t sync_reserved;
+    } __attribute__((packed));
+
 	struct { //Art-Net packet
     uint8_t  art_id[8];
     uint16_t art_opcode;
@@ -416,6 +416,7 @@ void realtimeLock(uint32_t timeoutMs, byte md)
       start = mainseg.start;
       stop  = mainseg.stop;
       mainseg.freeze = true;
+      mainseg.fill(BLACK); // clear segment buffer too, it is composited onto strip in strip.service()
     } else {
       start = 0;
       stop  = strip.getLengthTotal();
@@ -450,7 +451,7 @@ void exitRealtime() {
   strip.setBrightness(scaledBri(bri), true);
   realtimeTimeout = 0; // cancel realtime mode immediately
   realtimeMode = REALTIME_MODE_INACTIVE; // inform UI immediately
-  realtimeIP[0] = 0;
+  realtimeIP[0] = 0; // playout buffer is freed by handleRealtimePlayout()
   if (useMainSegmentOnly) { // unfreeze live segment again
     strip.getMainSegment().freeze = false;
   } else {
@@ -479,7 +480,10 @@ void handleNotifications()
     notify(notificationSentCallMode,true);
   }
 
-  if (e131NewData && millis() - strip.getLastShow() > 15)
+  handleE131Timeout();
+  handleRealtimePlayout();
+  // assembled frames are shown right away (they arrive at source's frame rate)
+  if (e131NewData && (e131WaitForFrame || millis() - strip.getLastShow() > 15))
   {
     e131NewData = false;
     strip.show();
@@ -510,13 +514,7 @@ void handleNotifications()
       rgbUdp.read(lbuf, packetSize);
       realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      unsigned id = 0;
-      unsigned totalLen = strip.getLengthTotal();
-      for (size_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, packetSize / 3, lbuf, 3, 3);
       if (!(realtimeMode && useMainSegmentOnly)) strip.show();
       return;
     }
@@ -628,7 +626,6 @@ void handleNotifications()
     }
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
-    unsigned totalLen = strip.getLengthTotal();
     if (udpIn[0] == 1 && packetSize > 5) //warls
     {
       for (size_t i = 2; i < packetSize -3; i += 4)
@@ -637,40 +634,18 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2 && packetSize > 4) //drgb
     {
-      unsigned id = 0;
-      for (size_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, (packetSize - 2) / 3, udpIn + 2, 3, 3);
     } else if (udpIn[0] == 3 && packetSize > 6) //drgbw
     {
-      unsigned id = 0;
-      for (size_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, (packetSize - 2) / 4, udpIn + 2, 4, 4);
     } else if (udpIn[0] == 4 && packetSize > 7) //dnrgb
     {
       unsigned id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
+      setRealtimePixels(id, (packetSize - 4) / 3, udpIn + 4, 3, 3);
     } else if (udpIn[0] == 5 && packetSize > 8) //dnrgbw
     {
       unsigned id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      setRealtimePixels(id, (packetSize - 4) / 4, udpIn + 4, 4, 4);
     }
     strip.show();
     return;
@@ -707,12 +682,260 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
     if (useMainSegmentOnly) {
       Segment &seg = strip.getMainSegment();
       if (pix<seg.length()) seg.setPixelColor(pix, r, g, b, w);
+    } else if (realtimeDirectOutput()) {
+      uint32_t c = RGBW32(r, g, b, w);
+      strip.setPixels(pix, 1, &c, true);
     } else {
       strip.setPixelColor(pix, r, g, b, w);
     }
   }
 }
 
+// direct output: colors of the selected inputs go straight to bus buffers (ledmap is still applied if respected)
+bool realtimeDirectOutput()
+{
+  switch (realtimeMode) {
+    case REALTIME_MODE_DDP      : return realtimeDirect & RT_DIRECT_DDP;
+    case REALTIME_MODE_E131     :
+    case REALTIME_MODE_ARTNET   : return realtimeDirect & RT_DIRECT_DMX;
+    case REALTIME_MODE_UDP      :
+    case REALTIME_MODE_HYPERION :
+    case REALTIME_MODE_TPM2NET  : return realtimeDirect & RT_DIRECT_UDP;
+    case REALTIME_MODE_ADALIGHT : return realtimeDirect & RT_DIRECT_SERIAL;
+    default                     : return false;
+  }
+}
+
+static void writeRealtimeColors(unsigned pix, unsigned n, const uint32_t *colors)
+{
+  if (useMainSegmentOnly) {
+    Segment &seg = strip.getMainSegment();
+    for (unsigned j = 0; j < n && pix + j < seg.length(); j++) seg.setPixelColor(pix + j, colors[j]);
+  } else {
+    strip.setPixels(pix, n, colors, realtimeDirectOutput());
+  }
+}
+
+/*
+ * Realtime playout (jitter) buffer
+ * complete DDP/E1.31/Art-Net frames are queued and shown at a steady cadence (or at their DDP timecode)
+ * assembled multi-universe E1.31/Art-Net frames are staged in it as well (without playout depth they are shown on next loop())
+ * frames are stored in a ring: last shown frame, up to realtimePlayoutDepth+1 queued frames and the frame being received
+ * the network callback only advances rtTail, handleRealtimePlayout() only advances rtHead
+ * the ring is only (re)allocated and freed by handleRealtimePlayout() in loop(), the network callback drops frames
+ * until it is available; on ESP32 the callback runs in its own task, allocation, frame assembly and playout clock
+ * are guarded by rtMutex (see lockRealtimePlayout())
+ */
+#ifdef ARDUINO_ARCH_ESP32
+static SemaphoreHandle_t rtMutex = xSemaphoreCreateRecursiveMutex();
+void lockRealtimePlayout()   { xSemaphoreTakeRecursive(rtMutex, portMAX_DELAY); }
+void unlockRealtimePlayout() { xSemaphoreGiveRecursive(rtMutex); }
+#else
+// network callbacks do not preempt loop() on ESP8266
+void lockRealtimePlayout()   {}
+void unlockRealtimePlayout() {}
+#endif
+struct PlayoutLock {
+  PlayoutLock()  { lockRealtimePlayout(); }
+  ~PlayoutLock() { unlockRealtimePlayout(); }
+};
+
+#define RT_PLAYOUT_SLOTS (RT_PLAYOUT_MAX_DEPTH+3)
+static uint32_t *rtFrames = nullptr;
+static uint16_t  rtFrameLen = 0;                   // strip length ring was (or could not be) allocated for
+static uint8_t   rtSlots = 0;
+static bool      rtNoMemory = false;               // ring could not be allocated, frames are shown as they arrive
+static uint32_t  rtFrameDue[RT_PLAYOUT_SLOTS];     // micros() when frame is to be shown
+static uint32_t  rtFrameArrival[RT_PLAYOUT_SLOTS]; // micros() when frame was complete
+static volatile uint32_t rtHead = 0;               // next frame to show (slot before it was shown last)
+static volatile uint32_t rtTail = 0;               // frame being received
+static volatile bool     rtAnchored = false;       // playout clock is running
+static volatile uint32_t rtInterval = 0;           // smoothed interval between source frames (us)
+static volatile uint32_t rtLastDue = 0;
+static uint32_t  rtLastArrival = 0;
+static uint32_t  rtTimecodeOffset = 0;             // local clock minus DDP timecode (us)
+static uint32_t  rtLastOutput = 0;                 // micros() of last frame shown
+
+static inline bool realtimePlayoutEnabled() {
+  if (realtimeOverride) return false;
+  if (realtimeMode == REALTIME_MODE_DDP) return realtimePlayoutDepth;
+  return e131WaitForFrame && (realtimeMode == REALTIME_MODE_E131 || realtimeMode == REALTIME_MODE_ARTNET); // back buffer for frame assembly
+}
+
+// must hold PlayoutLock
+static void freeRealtimePlayout()
+{
+  if (rtFrames) free(rtFrames);
+  rtFrames = nullptr;
+  rtFrameLen = 0;
+  rtSlots = 0;
+  rtNoMemory = false;
+  rtAnchored = false;
+  rtLastArrival = 0;
+}
+
+// must hold PlayoutLock
+static void allocateRealtimePlayout(unsigned len, unsigned slots)
+{
+  freeRealtimePlayout();
+  rtFrameLen = len;
+  rtSlots    = slots;
+  if (ESP.getFreeHeap() >= MIN_HEAP_SIZE + slots * len * sizeof(uint32_t)) rtFrames = static_cast<uint32_t*>(calloc(slots * len, sizeof(uint32_t)));
+  rtNoMemory = !rtFrames; // not retried until strip length or depth changes
+  rtHead = rtTail = slots; // slot before head must be valid
+}
+
+unsigned realtimePlayoutQueued()
+{
+  return rtFrames ? rtTail - rtHead : 0;
+}
+
+// called when a complete realtime frame was received: queues it for playout or lets handleNotifications() show it
+void presentRealtimeFrame(bool hasTimecode, uint32_t timecode)
+{
+  PlayoutLock lock;
+  if (!rtFrames) {
+    if (!realtimePlayoutEnabled() || rtNoMemory) e131NewData = true; // else frame was dropped (ring not allocated yet)
+    return;
+  }
+  const uint32_t now = micros();
+  if (rtLastArrival) {
+    uint32_t delta = now - rtLastArrival;
+    if (delta > 5000 && delta < 200000) rtInterval = rtInterval ? (rtInterval * 7 + delta) / 8 : delta; // ignore bursts and pauses
+  }
+  rtLastArrival = now;
+
+  const unsigned depth    = rtSlots - 3;
+  const uint32_t interval = rtInterval ? rtInterval : 25000; // assume 40 FPS until measured
+  const uint32_t tcMicros = (uint64_t(timecode) * 1000000UL) >> 16; // DDP timecode is in 1/65536 s
+  uint32_t due;
+  if (depth == 0) {
+    due = now; // no playout delay, show on next loop()
+  } else if (!rtAnchored) {
+    due = now + depth * interval; // start playout once buffer had time to fill
+    rtTimecodeOffset = due - tcMicros;
+    rtAnchored = true;
+  } else if (hasTimecode) {
+    due = tcMicros + rtTimecodeOffset;
+  } else {
+    due = rtLastDue + interval;
+  }
+  rtLastDue = due;
+
+  const uint32_t tail = rtTail;
+  if (tail - rtHead > depth) { // buffer full, next frame is received over this one
+    rtPlayoutDrops++;
+    return;
+  }
+  const unsigned slot = tail % rtSlots;
+  rtFrameDue[slot]     = due;
+  rtFrameArrival[slot] = now;
+  // next frame starts as a copy of this one as packets may update only a part of the strip
+  memcpy(rtFrames + ((tail + 1) % rtSlots) * rtFrameLen, rtFrames + slot * rtFrameLen, rtFrameLen * sizeof(uint32_t));
+  rtTail = tail + 1;
+}
+
+// (re)allocates or frees playout buffer, shows queued realtime frames when due, optionally blending last shown and next frame in between
+void handleRealtimePlayout()
+{
+  if (!realtimePlayoutEnabled()) {
+    if (rtFrameLen) {
+      PlayoutLock lock;
+      freeRealtimePlayout();
+    }
+    return;
+  }
+  const unsigned len   = strip.getLengthTotal();
+  const unsigned slots = min(realtimePlayoutDepth, (byte)RT_PLAYOUT_MAX_DEPTH) + 3;
+  if (rtFrameLen != len || rtSlots != slots) {
+    PlayoutLock lock;
+    allocateRealtimePlayout(len, slots);
+  }
+  if (!rtFrames) return;
+
+  const uint32_t now  = micros();
+  const uint32_t tail = rtTail;
+  uint32_t head = rtHead;
+  if (head == tail) {
+    PlayoutLock lock;
+    if (rtAnchored && int32_t(now - rtLastDue) > int32_t(rtInterval ? rtInterval : 25000)) {
+      rtAnchored = false; // nothing arrived in time, refill buffer
+      rtPlayoutUnderruns++;
+    }
+    return;
+  }
+  // skip frames that are late already (a newer one is due)
+  while (tail - head > 1 && int32_t(now - rtFrameDue[(head + 1) % rtSlots]) >= 0) {
+    head++;
+    rtPlayoutDrops++;
+  }
+  rtHead = head;
+
+  const unsigned slot = head % rtSlots;
+  const uint32_t *frame = rtFrames + slot * rtFrameLen;
+  if (int32_t(rtFrameDue[slot] - now) > 0) {
+    if (!realtimeInterpolate || now - rtLastOutput < strip.getFrameTime() * 1000U) return;
+    const unsigned prev = (head - 1) % rtSlots;
+    const uint32_t span = rtFrameDue[slot] - rtFrameDue[prev];
+    const uint32_t pos  = now - rtFrameDue[prev];
+    if (span == 0 || pos >= span || span > 4 * (rtInterval ? rtInterval : 25000)) return; // last shown frame is not the previous one
+    const uint8_t amount = (uint64_t(pos) * 255) / span;
+    const uint32_t *last = rtFrames + prev * rtFrameLen;
+    uint32_t colors[64];
+    for (unsigned i = 0; i < rtFrameLen; i += 64) {
+      const unsigned n = min(64U, unsigned(rtFrameLen - i));
+      for (unsigned j = 0; j < n; j++) colors[j] = color_blend(last[i+j], frame[i+j], amount);
+      writeRealtimeColors(i, n, colors);
+    }
+    strip.show();
+    rtLastOutput = now;
+    return;
+  }
+
+  writeRealtimeColors(0, rtFrameLen, frame);
+  strip.show();
+  const uint32_t latency = (now - rtFrameArrival[slot]) / 1000;
+  rtPlayoutLatency = (rtPlayoutLatency * 7 + (latency > 65535 ? 65535 : latency)) / 8;
+  rtLastOutput = now;
+  rtHead = head + 1;
+}
+
+// bulk version of setRealtimePixel(): pixels are read from data (stride bytes apart, 0 repeats the first pixel)
+// and handed to the strip in chunks instead of one by one (or stored in playout buffer)
+void setRealtimePixels(uint16_t i, uint16_t count, const uint8_t *data, uint8_t channels, uint8_t stride)
+{
+  int start = int(i) + arlsOffset; // offset may be negative
+  if (start < 0) { // clip pixels shifted below 0
+    if (unsigned(-start) >= count) return;
+    data  += unsigned(-start) * stride; // stride 0 repeats one color
+    count += start;
+    start  = 0;
+  }
+  PlayoutLock lock;
+  uint32_t *frame = nullptr;
+  if (realtimePlayoutEnabled()) {
+    if (rtFrames) frame = rtFrames + (rtTail % rtSlots) * rtFrameLen; // frame being received
+    else if (!rtNoMemory) return; // ring is allocated in loop(), drop data until then
+  }
+  unsigned pix = start;
+  const unsigned totalLen = frame ? rtFrameLen : strip.getLengthTotal();
+  if (pix >= totalLen) return;
+  if (count > totalLen - pix) count = totalLen - pix;
+  const bool gamma = !arlsDisableGammaCorrection && gammaCorrectCol;
+  uint32_t colors[64];
+  while (count > 0) {
+    const unsigned n = frame ? count : (count < 64 ? count : 64);
+    uint32_t *dst = frame ? frame + pix : colors;
+    for (unsigned j = 0; j < n; j++, data += stride) {
+      byte w = channels > 3 ? data[3] : 0;
+      dst[j] = gamma ? RGBW32(gamma8(data[0]), gamma8(data[1]), gamma8(data[2]), gamma8(w)) : RGBW32(data[0], data[1], data[2], w);
+    }
+    if (!frame) writeRealtimeColors(pix, n, colors);
+    pix   += n;
+    count -= n;
+  }
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
@@ -813,44 +1036,91 @@ void sendSysInfoUDP()
 // 1440 channels per packet
 #define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
 
-//
-// Send real time UDP updates to the specified client
-//
-// type   - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
-// client - the IP address to send to
-// length - the number of pixels
-// buffer - a buffer of at least length*4 bytes long
-// isRGBW - true if the buffer contains 4 components per pixel
+#define ARTNET_CHANNELS_PER_PACKET 512
+#define NET_BUS_PACKET_SIZE (DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET) // largest packet (Art-Net is 18+512)
 
 static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
 static const size_t ART_NET_HEADER_SIZE = 12;
 static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
+static WiFiUDP netBusUdp;               // shared by all network buses
+static byte   *netBusPacket = nullptr;  // packet is assembled here (allocated on first use)
+
+// copies channels scaled by brightness, 4 channels at a time (two per 16 bit lane)
+// every channel is scaled exactly like scale8(), (x * (bri+1)) >> 8 never overflows a lane
+static void scaleChannels(byte *dst, const byte *src, size_t len, uint8_t bri) {
+  if (bri == 255) { memcpy(dst, src, len); return; }
+  const uint32_t TWO_CHANNEL_MASK = 0x00FF00FF;
+  const uint32_t scale = bri + 1;
+  size_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    uint32_t c;
+    memcpy(&c, src + i, 4); // buffers are not aligned
+    c = ((((c & TWO_CHANNEL_MASK) * scale) >> 8) & TWO_CHANNEL_MASK) | ((((c >> 8) & TWO_CHANNEL_MASK) * scale) & ~TWO_CHANNEL_MASK);
+    memcpy(dst + i, &c, 4);
+  }
+  for (; i < len; i++) dst[i] = scale8(src[i], bri);
+}
+
+// sends assembled packet to all clients
+static bool sendPacket(const IPAddress *clients, netstats_t **stats, uint8_t numClients, uint16_t port, size_t size) {
+  bool ok = true;
+  for (unsigned c = 0; c < numClients; c++) {
+    unsigned long start = micros();
+    bool sent = netBusUdp.beginPacket(clients[c], port) && netBusUdp.write(netBusPacket, size) == size && netBusUdp.endPacket();
+    if (stats[c]) {
+      if (sent) { stats[c]->packets++; stats[c]->bytes += size; }
+      else      stats[c]->errors++;
+      stats[c]->sendTime += micros() - start;
+    }
+    ok &= sent;
+  }
+  return ok;
+}
+
+//
+// Send real time UDP updates to the specified clients
+// each packet is assembled (and scaled by brightness) once and then sent to every client
+//
+// type       - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
+// clients    - the IP addresses to send to
+// stats      - send statistics for each client (may contain nullptr)
+// numClients - number of clients
+// length     - the number of pixels
+// buffer     - a buffer of at least length*4 bytes long
+// isRGBW     - true if the buffer contains 4 components per pixel
+
+uint8_t realtimeBroadcast(uint8_t type, const IPAddress *clients, netstats_t **stats, uint8_t numClients, uint16_t length, const uint8_t *buffer, uint8_t bri, bool isRGBW)  {
+  if (!(apActive || interfacesInited) || !numClients || !length || !buffer) return 1;  // network not initialised  031522 ajn added check for ap
+  // skip dummy/unset IP addresses
+  IPAddress   dst[NET_BUS_MAX_FANOUT];
+  netstats_t *dstStats[NET_BUS_MAX_FANOUT];
+  unsigned n = 0;
+  for (unsigned c = 0; c < numClients && n < NET_BUS_MAX_FANOUT; c++) {
+    if (!clients[c][0]) continue;
+    dst[n] = clients[c];
+    dstStats[n++] = stats ? stats[c] : nullptr;
+  }
+  if (!n) return 1;
+  if (!netBusPacket) netBusPacket = (byte*)malloc(NET_BUS_PACKET_SIZE);
+  if (!netBusPacket) return 1;
+  for (unsigned c = 0; c < n; c++) if (dstStats[c]) dstStats[c]->sendTime = 0;
 
-  WiFiUDP ddpUdp;
+  const size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B,(W?) value
+  uint8_t err = 0;
 
   switch (type) {
     case 0: // DDP
     {
       // calculate the number of UDP packets we need to send
-      size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
       size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
 
       // there are 3 channels per RGB pixel
       uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
 
       for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
         if (sequenceNumber > 15) sequenceNumber = 0;
 
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          //DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
         // the amount of data is AFTER the header in the current packet
         size_t packetSize = DDP_CHANNELS_PER_PACKET;
 
@@ -864,33 +1134,23 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
           }
         }
 
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
+        // header
+        netBusPacket[0] = flags;
+        netBusPacket[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+        netBusPacket[2] = isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+        netBusPacket[3] = DDP_ID_DISPLAY;
         // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
+        netBusPacket[4] = 0xFF & (channel >> 24);
+        netBusPacket[5] = 0xFF & (channel >> 16);
+        netBusPacket[6] = 0xFF & (channel >>  8);
+        netBusPacket[7] = 0xFF & (channel      );
         // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+        netBusPacket[8] = 0xFF & (packetSize >> 8);
+        netBusPacket[9] = 0xFF & (packetSize     );
+        scaleChannels(netBusPacket + DDP_HEADER_LEN, buffer + channel, packetSize, bri);
 
-        if (!ddpUdp.endPacket()) {
-          //DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
+        // port defined in ESPAsyncE131.h; keep sending on error so other clients still get the frame
+        if (!sendPacket(dst, dstStats, n, DDP_DEFAULT_PORT, DDP_HEADER_LEN + packetSize)) err = 1;
 
         channel += packetSize;
       }
@@ -903,12 +1163,10 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
     case 2: //ArtNet
     {
       // calculate the number of UDP packets we need to send
-      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
-      const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
-      const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
+      const size_t channelsPerPacket = isRGBW ? ARTNET_CHANNELS_PER_PACKET : ARTNET_CHANNELS_PER_PACKET-2; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
+      const size_t packetCount = ((channelCount-1)/channelsPerPacket)+1;
 
-      uint32_t channel = 0; 
-      size_t bufferOffset = 0;
+      uint32_t channel = 0;
 
       sequenceNumber++;
 
@@ -916,46 +1174,33 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
 
         if (sequenceNumber > 255) sequenceNumber = 0;
 
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
-
-        size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
+        size_t packetSize = channelsPerPacket;
 
         if (currentPacket == (packetCount - 1U)) {
           // last packet
-          if (channelCount % ARTNET_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % ARTNET_CHANNELS_PER_PACKET;
+          if (channelCount % channelsPerPacket) {
+            packetSize = channelCount % channelsPerPacket;
           }
         }
 
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+        memcpy_P(netBusPacket, ART_NET_HEADER, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
+        netBusPacket[12] = sequenceNumber & 0xFF; // sequence number. 1..255
+        netBusPacket[13] = 0x00; // physical - more an FYI, not really used for anything. 0..3
+        netBusPacket[14] = currentPacket & 0xFF; // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
+        netBusPacket[15] = 0x00; // Universe MSB, unused.
+        netBusPacket[16] = 0xFF & (packetSize >> 8); // 16-bit length of channel data, MSB
+        netBusPacket[17] = 0xFF & (packetSize     ); // 16-bit length of channel data, LSB
+        scaleChannels(netBusPacket + ART_NET_HEADER_SIZE + 6, buffer + channel, packetSize, bri);
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
-          return 1; // borked
-        }
+        if (!sendPacket(dst, dstStats, n, ARTNET_DEFAULT_PORT, ART_NET_HEADER_SIZE + 6 + packetSize)) err = 1;
         channel += packetSize;
       }
     } break;
   }
-  return 0;
+  #ifdef WLED_DEBUG
+  if (err) DEBUG_PRINTLN(F("Network bus: WiFiUDP send returned an error"));
+  #endif
+  return err;
 }
 
 #ifndef WLED_DISABLE_ESPNOW
@@ -349,6 +349,7 @@ void WLED::setup()
   #ifdef WLED_BOOTUPDELAY
   delay(WLED_BOOTUPDELAY); // delay to let voltage stabilize, helps with boot issues on some setups
   #endif
+  Serial.setRxBufferSize(WLED_SERIAL_RX_BUFSIZE); // room for Adalight/TPM2 frames between loops (must be set before begin())
   Serial.begin(115200);
   #if !ARDUINO_USB_CDC_ON_BOOT
   Serial.setTimeout(50);  // this causes troubles on new MCUs that have a "virtual" USB Serial (HWCDC)
@@ -188,6 +188,7 @@ using PSRAMDynamicJsonDocument = BasicJsonDocument<PSRAM_Allocator>;
 #include "pin_manager.h"
 #include "bus_manager.h"
 #include "FX.h"
+#include "perf.h"
 
 #ifndef CLIENT_SSID
   #define CLIENT_SSID DEFAULT_CLIENT_SSID
@@ -470,6 +471,8 @@ WLED_GLOBAL uint16_t DMXSegmentSpacing _INIT(0);                  // Number of v
 WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+WLED_GLOBAL bool e131WaitForFrame _INIT(false);                   // show multi-universe frames only when complete (all universes, sync packet or timeout)
+WLED_GLOBAL uint16_t e131FrameTimeout _INIT(20);                  // ms to wait for missing universes before showing incomplete frame
 WLED_GLOBAL uint16_t pollReplyCount _INIT(0);                     // count number of replies for ArtPoll node report
 
 // mqtt
@@ -579,6 +582,7 @@ WLED_GLOBAL byte lastRandomIndex _INIT(0);        // used to save last random co
 // transitions
 WLED_GLOBAL bool          fadeTransition           _INIT(true);   // enable crossfading brightness/color
 WLED_GLOBAL bool          modeBlending             _INIT(true);   // enable effect blending
+WLED_GLOBAL uint8_t       blendingStyle            _INIT(BLEND_STYLE_FADE); // effect blending style (see FX.h)
 WLED_GLOBAL bool          transitionActive         _INIT(false);
 WLED_GLOBAL uint16_t      transitionDelay          _INIT(750);    // global transition duration
 WLED_GLOBAL uint16_t      transitionDelayDefault   _INIT(750);    // default transition time (stored in cfg.json)
@@ -880,6 +884,15 @@ WLED_GLOBAL WiFiUDP ntpUdp;
 WLED_GLOBAL ESPAsyncE131 e131 _INIT_N(((handleE131Packet)));
 WLED_GLOBAL ESPAsyncE131 ddp  _INIT_N(((handleE131Packet)));
 WLED_GLOBAL bool e131NewData _INIT(false);
+WLED_GLOBAL byte realtimePlayoutDepth _INIT(0);      // frames held in realtime playout (jitter) buffer, 0 shows frames as they arrive
+WLED_GLOBAL bool realtimeInterpolate _INIT(false);   // blend consecutive buffered frames at target FPS
+WLED_GLOBAL byte realtimeDirect _INIT(0);            // RT_DIRECT_* inputs written to bus buffers as received (no auto white & white balance)
+WLED_GLOBAL uint32_t rtPlayoutUnderruns _INIT(0);    // playout buffer ran empty
+WLED_GLOBAL uint32_t rtPlayoutDrops _INIT(0);        // frames skipped (buffer full or late)
+WLED_GLOBAL uint16_t rtPlayoutLatency _INIT(0);      // average ms between frame completion and showing it
+WLED_GLOBAL uint32_t e131Frames _INIT(0);        // frames presented by E1.31/Art-Net frame assembly
+WLED_GLOBAL uint32_t e131PartialFrames _INIT(0); // frames presented with universes missing
+WLED_GLOBAL uint32_t e131LatePackets _INIT(0);   // packets dropped as their frame was already presented
 
 // led fx library object
 WLED_GLOBAL BusManager busses _INIT(BusManager());
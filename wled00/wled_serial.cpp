@@ -11,14 +11,29 @@ enum class AdaState {
   Header_CountHi,
   Header_CountLo,
   Header_CountCheck,
-  Data_Red,
-  Data_Green,
-  Data_Blue,
+  Data,
   TPM2_Header_Type,
   TPM2_Header_CountHi,
   TPM2_Header_CountLo,
+  TPM2_End,
 };
 
+#define SERIAL_RX_BLOCK   256 // bytes drained from UART/USB CDC FIFO at once
+#define SERIAL_RX_TIMEOUT 200 // ms of silence that end a truncated frame or a resync
+
+// frame payload is read in blocks into serialFrame and applied to the strip once complete
+static AdaState serialState = AdaState::Header_A;
+static uint8_t *serialFrame = nullptr;
+static size_t   serialFrameSize = 0; // allocated bytes
+static size_t   serialFrameLen = 0;  // payload bytes kept (fitting the strip)
+static size_t   serialPayload = 0;   // payload bytes of the frame
+static size_t   serialPos = 0;       // payload bytes received
+static uint16_t serialCount = 0;
+static bool     serialTPM2 = false;
+static byte     serialCheck = 0x00;
+static bool     serialResync = false; // stream is out of sync: bytes outside of a valid frame are dropped, never run as commands
+static unsigned long serialLastRx = 0;
+
 uint16_t currentBaud = 1152; //default baudrate 115200 (divided by 100)
 bool continuousSendLED = false;
 uint32_t lastUpdate = 0;
@@ -67,120 +82,223 @@ void sendBytes(){
   }
 }
 
+static void freeSerialFrame() {
+  if (serialFrame) free(serialFrame);
+  serialFrame = nullptr;
+  serialFrameSize = 0;
+}
+
+static void startSerialFrame(size_t payload, bool tpm2) {
+  serialTPM2 = tpm2;
+  serialPayload = payload;
+  serialPos = 0;
+  size_t len = strip.getLengthTotal() * 3;
+  size_t pixelBytes = payload - payload % 3; // whole pixels are applied (all payload bytes are received)
+  serialFrameLen = pixelBytes < len ? pixelBytes : len;
+  if (serialFrameSize < serialFrameLen) {
+    freeSerialFrame();
+    if (ESP.getFreeHeap() >= MIN_HEAP_SIZE + serialFrameLen) serialFrame = (uint8_t*)malloc(serialFrameLen);
+    if (serialFrame) serialFrameSize = serialFrameLen;
+  }
+  if (!serialFrame) serialFrameLen = 0; // frame is received but dropped
+  serialState = payload ? AdaState::Data : (tpm2 ? AdaState::TPM2_End : AdaState::Header_A);
+}
+
+static void applySerialFrame() {
+  serialState = serialTPM2 ? AdaState::TPM2_End : AdaState::Header_A;
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
+  if (realtimeOverride || !serialFrameLen) return;
+  setRealtimePixels(0, serialFrameLen / 3, serialFrame, 3, 3);
+  strip.show();
+}
+
+// advances frame header state machine, returns false if byte does not belong to a frame (serial command)
+// a byte breaking a partial header is checked again as the start of a new frame
+static bool parseSerialHeader(byte next) {
+  switch (serialState) {
+    case AdaState::TPM2_End:
+      serialState = AdaState::Header_A;
+      if (next == 0x36) { serialResync = false; return true; } // TPM2 end byte, frame length was right
+      serialResync = true;
+      parseSerialHeader(next);
+      return true;
+    case AdaState::Header_A:
+      if      (next == 'A')  serialState = AdaState::Header_d;
+      else if (next == 0xC9) serialState = AdaState::TPM2_Header_Type; //TPM2 start byte
+      else return false;
+      break;
+    case AdaState::Header_d:
+      if (next != 'd') { serialState = AdaState::Header_A; return parseSerialHeader(next); }
+      serialState = AdaState::Header_a;
+      break;
+    case AdaState::Header_a:
+      if (next != 'a') { serialState = AdaState::Header_A; return parseSerialHeader(next); }
+      serialState = AdaState::Header_CountHi;
+      break;
+    case AdaState::Header_CountHi:
+      serialCount = next * 0x100;
+      serialCheck = next;
+      serialState = AdaState::Header_CountLo;
+      break;
+    case AdaState::Header_CountLo:
+      serialCount += next;
+      serialCheck = serialCheck ^ next ^ 0x55;
+      serialState = AdaState::Header_CountCheck;
+      break;
+    case AdaState::Header_CountCheck:
+      if (serialCheck == next) {
+        serialResync = false; // full header with valid checksum
+        startSerialFrame((serialCount + 1U) * 3, false);
+      } else {
+        serialResync = true; // skip payload of corrupted frame
+        serialState = AdaState::Header_A;
+        parseSerialHeader(next);
+      }
+      break;
+    case AdaState::TPM2_Header_Type:
+      if (next == 0xDA) serialState = AdaState::TPM2_Header_CountHi; //TPM2 data
+      else {
+        serialState = AdaState::Header_A;
+        if (next != 0xAA) return parseSerialHeader(next); //(unsupported) TPM2 command or invalid type
+        if (!serialResync) Serial.write(0xAC); //TPM2 ping
+      }
+      break;
+    case AdaState::TPM2_Header_CountHi:
+      serialCount = next * 0x100;
+      serialState = AdaState::TPM2_Header_CountLo;
+      break;
+    case AdaState::TPM2_Header_CountLo:
+      serialCount += next;
+      startSerialFrame(serialCount, true);
+      break;
+    default: break;
+  }
+  return true;
+}
+
+static void advanceSerialPayload(size_t n) {
+  serialPos += n;
+  if (serialPos == serialPayload) applySerialFrame();
+}
+
+// stores up to len payload bytes, returns number of bytes consumed
+static size_t storeSerialPayload(const uint8_t *data, size_t len) {
+  size_t n = serialPayload - serialPos;
+  if (len < n) n = len;
+  if (serialPos < serialFrameLen) memcpy(serialFrame + serialPos, data, (serialFrameLen - serialPos < n) ? serialFrameLen - serialPos : n);
+  advanceSerialPayload(n);
+  return n;
+}
+
+// next frame header ('A' of "Ada" or TPM2 start byte) in data
+static const uint8_t *findSerialHeader(const uint8_t *data, size_t len) {
+  const uint8_t *a = (const uint8_t*)memchr(data, 'A', len);
+  const uint8_t *t = (const uint8_t*)memchr(data, 0xC9, a ? a - data : len);
+  return t ? t : a;
+}
+
+// parses bytes drained from the FIFO while resyncing, bytes outside of frames are dropped (never run as commands)
+// resync ends with a full Adalight header and checksum, or with a TPM2 frame followed by its end byte
+static void parseSerialBlock(const uint8_t *data, size_t len) {
+  const uint8_t *end = data + len;
+  while (data < end) {
+    if (serialState == AdaState::Data) {
+      data += storeSerialPayload(data, end - data);
+    } else if (serialState == AdaState::Header_A) {
+      data = findSerialHeader(data, end - data);
+      if (!data) return;
+      parseSerialHeader(*data++);
+    } else {
+      parseSerialHeader(*data++);
+    }
+  }
+}
+
 void handleSerial()
 {
   if (!(serialCanRX && Serial)) return; // arduino docs: `if (Serial)` indicates whether or not the USB CDC serial connection is open. For all non-USB CDC ports, this will always return true
 
-  static auto state = AdaState::Header_A;
-  static uint16_t count = 0;
-  static uint16_t pixel = 0;
-  static byte check = 0x00;
-  static byte red   = 0x00;
-  static byte green = 0x00;
+  if (serialFrame && serialState == AdaState::Header_A && realtimeMode != REALTIME_MODE_ADALIGHT) freeSerialFrame();
+
+  // a silent line ends a truncated frame or an unfinished resync, so serial commands are parsed again
+  if ((serialResync || serialState != AdaState::Header_A) && !Serial.available() && millis() - serialLastRx > SERIAL_RX_TIMEOUT) {
+    serialState = AdaState::Header_A;
+    serialResync = false;
+  }
 
-  while (Serial.available() > 0)
+  uint8_t block[SERIAL_RX_BLOCK];
+  int avail;
+  while ((avail = Serial.available()) > 0)
   {
-    yield();
+    serialLastRx = millis();
+    // frame payload is drained in blocks (not beyond its end so commands following a frame are kept in FIFO)
+    if (serialState == AdaState::Data) {
+      size_t n = serialPayload - serialPos;
+      if (n > (size_t)avail) n = avail;
+      if (serialPos < serialFrameLen) {
+        if (n > serialFrameLen - serialPos) n = serialFrameLen - serialPos;
+        n = Serial.read(serialFrame + serialPos, n);
+      } else {
+        if (n > sizeof(block)) n = sizeof(block);
+        n = Serial.read(block, n); // bytes beyond strip length are dropped
+      }
+      if (!n) break;
+      advanceSerialPayload(n);
+      yield();
+      continue;
+    }
+    // after a corrupted frame data is searched for the next valid frame
+    if (serialResync) {
+      size_t n = Serial.read(block, (size_t)avail < sizeof(block) ? (size_t)avail : sizeof(block));
+      if (!n) break;
+      parseSerialBlock(block, n);
+      yield();
+      continue;
+    }
+
     byte next = Serial.peek();
-    switch (state) {
-      case AdaState::Header_A:
-        if      (next == 'A')  { state = AdaState::Header_d; }
-        else if (next == 0xC9) { state = AdaState::TPM2_Header_Type; } //TPM2 start byte
-        else if (next == 'I')  { handleImprovPacket(); return; }
-        else if (next == 'v')  { Serial.print("WLED"); Serial.write(' '); Serial.println(VERSION); }
-        else if (next == 0xB0) { updateBaudRate( 115200); }
-        else if (next == 0xB1) { updateBaudRate( 230400); }
-        else if (next == 0xB2) { updateBaudRate( 460800); }
-        else if (next == 0xB3) { updateBaudRate( 500000); }
-        else if (next == 0xB4) { updateBaudRate( 576000); }
-        else if (next == 0xB5) { updateBaudRate( 921600); }
-        else if (next == 0xB6) { updateBaudRate(1000000); }
-        else if (next == 0xB7) { updateBaudRate(1500000); }
-        else if (next == 'l')  { sendJSON(); } // Send LED data as JSON Array
-        else if (next == 'L')  { sendBytes(); } // Send LED data as TPM2 Data Packet
-        else if (next == 'o')  { continuousSendLED = false; } // Disable Continuous Serial Streaming
-        else if (next == 'O')  { continuousSendLED = true; } // Enable Continuous Serial Streaming
-        else if (next == '{')  { //JSON API
-          bool verboseResponse = false;
-          if (!requestJSONBufferLock(16)) {
-            Serial.printf_P(PSTR("{\"error\":%d}\n"), ERR_NOBUF);
-            return;
-          }
-          Serial.setTimeout(100);
-          DeserializationError error = deserializeJson(*pDoc, Serial);
-          if (!error) {
-            verboseResponse = deserializeState(pDoc->as<JsonObject>());
-            //only send response if TX pin is unused for other purposes
-            if (verboseResponse && serialCanTX) {
-              pDoc->clear();
-              JsonObject state = pDoc->createNestedObject("state");
-              serializeState(state);
-              JsonObject info  = pDoc->createNestedObject("info");
-              serializeInfo(info);
-
-              serializeJson(*pDoc, Serial);
-              Serial.println();
-            }
-          }
-          releaseJSONBufferLock();
+    if (!parseSerialHeader(next)) {
+      if      (next == 'I')  { handleImprovPacket(); return; }
+      else if (next == 'v')  { Serial.print("WLED"); Serial.write(' '); Serial.println(VERSION); }
+      else if (next == 0xB0) { updateBaudRate( 115200); }
+      else if (next == 0xB1) { updateBaudRate( 230400); }
+      else if (next == 0xB2) { updateBaudRate( 460800); }
+      else if (next == 0xB3) { updateBaudRate( 500000); }
+      else if (next == 0xB4) { updateBaudRate( 576000); }
+      else if (next == 0xB5) { updateBaudRate( 921600); }
+      else if (next == 0xB6) { updateBaudRate(1000000); }
+      else if (next == 0xB7) { updateBaudRate(1500000); }
+      else if (next == 0xB8) { updateBaudRate(2000000); }
+      else if (next == 0xB9) { updateBaudRate(3000000); }
+      else if (next == 0xBA) { updateBaudRate(4000000); }
+      else if (next == 'l')  { sendJSON(); } // Send LED data as JSON Array
+      else if (next == 'L')  { sendBytes(); } // Send LED data as TPM2 Data Packet
+      else if (next == 'o')  { continuousSendLED = false; } // Disable Continuous Serial Streaming
+      else if (next == 'O')  { continuousSendLED = true; } // Enable Continuous Serial Streaming
+      else if (next == '{')  { //JSON API
+        bool verboseResponse = false;
+        if (!requestJSONBufferLock(16)) {
+          Serial.printf_P(PSTR("{\"error\":%d}\n"), ERR_NOBUF);
+          return;
         }
-        break;
-      case AdaState::Header_d:
-        if (next == 'd') state = AdaState::Header_a;
-        else             state = AdaState::Header_A;
-        break;
-      case AdaState::Header_a:
-        if (next == 'a') state = AdaState::Header_CountHi;
-        else             state = AdaState::Header_A;
-        break;
-      case AdaState::Header_CountHi:
-        pixel = 0;
-        count = next * 0x100;
-        check = next;
-        state = AdaState::Header_CountLo;
-        break;
-      case AdaState::Header_CountLo:
-        count += next + 1;
-        check = check ^ next ^ 0x55;
-        state = AdaState::Header_CountCheck;
-        break;
-      case AdaState::Header_CountCheck:
-        if (check == next) state = AdaState::Data_Red;
-        else               state = AdaState::Header_A;
-        break;
-      case AdaState::TPM2_Header_Type:
-        state = AdaState::Header_A; //(unsupported) TPM2 command or invalid type
-        if (next == 0xDA) state = AdaState::TPM2_Header_CountHi; //TPM2 data
-        else if (next == 0xAA) Serial.write(0xAC); //TPM2 ping
-        break;
-      case AdaState::TPM2_Header_CountHi:
-        pixel = 0;
-        count = (next * 0x100) /3;
-        state = AdaState::TPM2_Header_CountLo;
-        break;
-      case AdaState::TPM2_Header_CountLo:
-        count += next /3;
-        state = AdaState::Data_Red;
-        break;
-      case AdaState::Data_Red:
-        red   = next;
-        state = AdaState::Data_Green;
-        break;
-      case AdaState::Data_Green:
-        green = next;
-        state = AdaState::Data_Blue;
-        break;
-      case AdaState::Data_Blue:
-        byte blue  = next;
-        if (!realtimeOverride) setRealtimePixel(pixel++, red, green, blue, 0);
-        if (--count > 0) state = AdaState::Data_Red;
-        else {
-          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
-
-          if (!realtimeOverride) strip.show();
-          state = AdaState::Header_A;
+        Serial.setTimeout(100);
+        DeserializationError error = deserializeJson(*pDoc, Serial);
+        if (!error) {
+          verboseResponse = deserializeState(pDoc->as<JsonObject>());
+          //only send response if TX pin is unused for other purposes
+          if (verboseResponse && serialCanTX) {
+            pDoc->clear();
+            JsonObject state = pDoc->createNestedObject("state");
+            serializeState(state);
+            JsonObject info  = pDoc->createNestedObject("info");
+            serializeInfo(info);
+
+            serializeJson(*pDoc, Serial);
+            Serial.println();
+          }
         }
-        break;
+        releaseJSONBufferLock();
+      }
     }
 
     // All other received bytes will disable Continuous Serial Streaming
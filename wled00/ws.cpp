@@ -7,9 +7,12 @@
 
 uint16_t wsLiveClientId = 0;
 unsigned long wsLastLiveTime = 0;
+uint16_t wsPerfClientId = 0;
+unsigned long wsLastPerfTime = 0;
 //uint8_t* wsFrameBuffer = nullptr;
 
 #define WS_LIVE_INTERVAL 40
+#define WS_PERF_INTERVAL 1000
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
@@ -20,6 +23,7 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    if (client->id() == wsPerfClientId) wsPerfClientId = 0;
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
@@ -52,6 +56,8 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           verboseResponse = true;
         } else if (root.containsKey("lv")) {
           wsLiveClientId = root["lv"] ? client->id() : 0;
+        } else if (root.containsKey("perf")) {
+          wsPerfClientId = root["perf"] ? client->id() : 0; // stream profiling data
         } else {
           verboseResponse = deserializeState(root);
         }
@@ -160,6 +166,26 @@ void sendDataWs(AsyncWebSocketClient * client)
   releaseJSONBufferLock();
 }
 
+bool sendPerfWs(uint32_t wsClient)
+{
+  AsyncWebSocketClient * wsc = ws.client(wsClient);
+  if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
+
+  if (!requestJSONBufferLock(23)) return false;
+  JsonObject perf = pDoc->createNestedObject("perf");
+  serializePerf(perf);
+  size_t len = measureJson(*pDoc);
+  AsyncWebSocketBuffer buffer(len);
+  if (!buffer) {
+    releaseJSONBufferLock();
+    return false;
+  }
+  serializeJson(*pDoc, (char *)buffer.data(), len);
+  releaseJSONBufferLock();
+  wsc->text(std::move(buffer));
+  return true;
+}
+
 bool sendLiveLedsWs(uint32_t wsClient)
 {
   AsyncWebSocketClient * wsc = ws.client(wsClient);
@@ -233,6 +259,9 @@ void handleWs()
     wsLastLiveTime = millis();
     if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
   }
+  if (wsPerfClientId && millis() - wsLastPerfTime > WS_PERF_INTERVAL) {
+    if (sendPerfWs(wsPerfClientId)) wsLastPerfTime = millis();
+  }
 }
 
 #else
@@ -287,6 +287,8 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     printSetFormCheckbox(settingsScript,PSTR("CR"),strip.cctFromRgb);
     printSetFormValue(settingsScript,PSTR("CB"),strip.cctBlending);
     printSetFormValue(settingsScript,PSTR("FR"),strip.getTargetFps());
+    printSetFormValue(settingsScript,PSTR("FB"),strip.getFrameBudget());
+    printSetFormValue(settingsScript,PSTR("NK"),BusNetwork::getKeepAlive());
     printSetFormValue(settingsScript,PSTR("AW"),Bus::getGlobalAWMode());
     printSetFormCheckbox(settingsScript,PSTR("LD"),useGlobalLedBuffer);
 
@@ -306,6 +308,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
       char aw[4] = "AW"; aw[2] = offset+s; aw[3] = 0; //auto white mode
       char wo[4] = "WO"; wo[2] = offset+s; wo[3] = 0; //swap channels
       char sp[4] = "SP"; sp[2] = offset+s; sp[3] = 0; //bus clock speed
+      char nr[4] = "NR"; nr[2] = offset+s; nr[3] = 0; //max frame rate (network)
       char la[4] = "LA"; la[2] = offset+s; la[3] = 0; //LED current
       char ma[4] = "MA"; ma[2] = offset+s; ma[3] = 0; //max per-port PSU current
       settingsScript.print(F("addLEDs(1);"));
@@ -345,6 +348,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
         }
       }
       printSetFormValue(settingsScript,sp,speed);
+      if (bus->isVirtual()) printSetFormValue(settingsScript,nr,bus->getFrequency());
       printSetFormValue(settingsScript,la,bus->getLEDCurrent());
       printSetFormValue(settingsScript,ma,bus->getMaxCurrent());
       sumMa += bus->getMaxCurrent();
@@ -352,6 +356,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     printSetFormValue(settingsScript,PSTR("MA"),BusManager::ablMilliampsMax() ? BusManager::ablMilliampsMax() : sumMa);
     printSetFormCheckbox(settingsScript,PSTR("ABL"),BusManager::ablMilliampsMax() || sumMa > 0);
     printSetFormCheckbox(settingsScript,PSTR("PPL"),!BusManager::ablMilliampsMax() && sumMa > 0);
+    printSetFormCheckbox(settingsScript,PSTR("AS"),BusManager::getABLSmoothing());
 
     settingsScript.printf_P(PSTR("resetCOM(%d);"), WLED_MAX_COLOR_ORDER_MAPPINGS);
     const ColorOrderMap& com = BusManager::getColorOrderMap();
@@ -371,6 +376,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     dtostrf(gammaCorrectVal,3,1,nS); printSetFormValue(settingsScript,PSTR("GV"),nS);
     printSetFormCheckbox(settingsScript,PSTR("TF"),fadeTransition);
     printSetFormCheckbox(settingsScript,PSTR("EB"),modeBlending);
+    printSetFormValue(settingsScript,PSTR("BS"),blendingStyle);
     printSetFormValue(settingsScript,PSTR("TD"),transitionDelayDefault);
     printSetFormCheckbox(settingsScript,PSTR("PF"),strip.paletteFade);
     printSetFormValue(settingsScript,PSTR("TP"),randomPaletteChangeTime);
@@ -432,8 +438,16 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     printSetFormCheckbox(settingsScript,PSTR("RD"),receiveDirect);
     printSetFormCheckbox(settingsScript,PSTR("MO"),useMainSegmentOnly);
     printSetFormCheckbox(settingsScript,PSTR("RLM"),realtimeRespectLedMaps);
+    printSetFormValue(settingsScript,PSTR("JB"),realtimePlayoutDepth);
+    printSetFormCheckbox(settingsScript,PSTR("JI"),realtimeInterpolate);
+    printSetFormCheckbox(settingsScript,PSTR("DOD"),realtimeDirect & RT_DIRECT_DDP);
+    printSetFormCheckbox(settingsScript,PSTR("DOE"),realtimeDirect & RT_DIRECT_DMX);
+    printSetFormCheckbox(settingsScript,PSTR("DOU"),realtimeDirect & RT_DIRECT_UDP);
+    printSetFormCheckbox(settingsScript,PSTR("DOS"),realtimeDirect & RT_DIRECT_SERIAL);
     printSetFormValue(settingsScript,PSTR("EP"),e131Port);
     printSetFormCheckbox(settingsScript,PSTR("ES"),e131SkipOutOfSequence);
+    printSetFormCheckbox(settingsScript,PSTR("EF"),e131WaitForFrame);
+    printSetFormValue(settingsScript,PSTR("EO"),e131FrameTimeout);
     printSetFormCheckbox(settingsScript,PSTR("EM"),e131Multicast);
     printSetFormValue(settingsScript,PSTR("EU"),e131Universe);
     printSetFormValue(settingsScript,PSTR("DA"),DMXAddress);